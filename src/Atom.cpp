@@ -0,0 +1,124 @@
+#include "Atom.h"
+#include "CompilerStringDefines.h"
+#include "ConsolePrinter.h"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+// Must match the order of the Atoms enum.
+static const char* const predefinedAtoms[] = {
+    "",
+
+    T_STR_BOOLEAN,
+    T_STR_INT,
+    T_STR_VOID,
+    T_STR_STRING,
+    T_STR_ARRAY,
+    T_STR_THIS,
+    "(typeless)",
+
+    "this",
+    "void",
+    "main",
+
+    O_STR_ADD,
+    O_STR_SUB,
+    O_STR_MUL,
+    O_STR_DIV,
+    O_STR_LT,
+    O_STR_GT,
+    O_STR_LEQ,
+    O_STR_GEQ,
+    O_STR_EQ,
+    O_STR_NE,
+    O_STR_AND,
+    O_STR_OR,
+    O_STR_NOT,
+
+    "call",
+    "param",
+    "arg",
+    "jump",
+    "length",
+    "new",
+    "newArr",
+    "[]",
+    "[]=",
+    "return",
+    "system.print",
+    "stop"
+};
+
+static_assert(sizeof(predefinedAtoms) / sizeof(predefinedAtoms[0]) == Atoms::COUNT, "Every predefined atom needs a string.");
+
+class AtomTable
+{
+public:
+    AtomTable()
+    {
+        for (const char* str : predefinedAtoms)
+        {
+            Intern(str);
+        }
+    }
+
+    Atom Intern(std::string_view str)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+
+            auto it = atoms.find(str);
+            if (it != atoms.end())
+            {
+                return it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex);
+
+        // Another thread may have added the string since the shared lock was released.
+        auto it = atoms.find(str);
+        if (it != atoms.end())
+        {
+            return it->second;
+        }
+
+        Atom atom = (Atom)strings.size();
+        // The deque never moves its strings, so the map can key on views into them.
+        const std::string& stored = strings.emplace_back(str);
+        atoms.emplace(stored, atom);
+
+        return atom;
+    }
+
+    const std::string& GetString(Atom atom)
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        Assert(atom < strings.size(), "Atom %u was never interned.", atom);
+
+        return strings[atom];
+    }
+
+private:
+    std::shared_mutex mutex;
+    std::deque<std::string> strings;
+    std::unordered_map<std::string_view, Atom> atoms;
+};
+
+static AtomTable& GetAtomTable()
+{
+    static AtomTable atomTable;
+    return atomTable;
+}
+
+Atom Intern(std::string_view str)
+{
+    return GetAtomTable().Intern(str);
+}
+
+const std::string& AtomToString(Atom atom)
+{
+    return GetAtomTable().GetString(atom);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// An interned string. Equal strings always get the same atom,
+// so atoms are compared and hashed as plain integers.
+typedef uint32_t Atom;
+
+// Get the atom of a string, interning it if it is new. Safe to call from multiple threads.
+Atom Intern(std::string_view str);
+
+// Get the string of an atom. The reference stays valid until the program exits.
+const std::string& AtomToString(Atom atom);
+
+inline const char* AtomCStr(Atom atom)
+{
+    return AtomToString(atom).c_str();
+}
+
+// Atoms of the strings the compiler compares against. These are interned first, in this order,
+// so they can be used as constants.
+namespace Atoms
+{
+    enum : Atom
+    {
+        EMPTY,
+
+        // Types
+        BOOLEAN,
+        INT,
+        VOID,
+        STRING,
+        ARRAY,
+        THIS, // The variable that refers to the object of a class.
+        NO_TYPE,
+
+        // Keywords
+        THIS_KEYWORD,
+        VOID_KEYWORD,
+        MAIN,
+
+        // Operators
+        ADD,
+        SUB,
+        MUL,
+        DIV,
+        LT,
+        GT,
+        LEQ,
+        GEQ,
+        EQ,
+        NE,
+        AND,
+        OR,
+        NOT,
+
+        // TAC operations
+        TAC_CALL,
+        TAC_PARAM,
+        TAC_ARG,
+        TAC_JUMP,
+        TAC_LENGTH,
+        TAC_NEW,
+        TAC_NEW_ARR,
+        TAC_INDEX,
+        TAC_ASSIGN_INDEXED,
+        TAC_RETURN,
+        TAC_PRINT,
+        TAC_STOP,
+
+        COUNT
+    };
+}
@@ -2,24 +2,20 @@
 #include "CompilerStringDefines.h"
 #include "ConsolePrinter.h"
 #include "BytecodeDefinitions.h"
-#include "Utils.h"
 
 #include <unordered_map>
-#include <fstream>
-#include <algorithm> // std::remove
-
-#define STR_INS(operator, arg) std::string(operator) + " " + arg
+#include <charconv>
 
 using namespace BytecodeDefinitions;
 
-void BytecodeContainer::AddUncondJumpInstruction(const std::string& label)
+void BytecodeContainer::AddUncondJumpInstruction(Atom label)
 {
     AddJump(label);
 }
 
-void BytecodeContainer::AddCondJumpInstruction(const std::string& label)
+void BytecodeContainer::AddCondJumpInstruction(Atom label)
 {
-    AddAny(std::string(IFFALSE) + " " + GOTO + " " + label);
+    Add(BytecodeInstruction::IFFALSE, label);
 }
 
 bool IsLiteral(const std::string& symbol)
@@ -33,151 +29,156 @@ bool IsLiteral(const std::string& symbol)
     return isLiteralNumber || isLiteralBool;
 }
 
-BytecodeContainer& BytecodeContainer::AddAny(const std::string& rawInstruction)
+int32_t ParseLiteral(const std::string& symbol)
 {
-    bytecodeInstructions.push_back(rawInstruction);
+    if (symbol == "true" || symbol == "false")
+    {
+        return symbol == "true" ? 1 : 0;
+    }
 
-    return *this;
+    int32_t num;
+    std::from_chars_result result = std::from_chars(symbol.data(), symbol.data() + symbol.size(), num);
+    // This assertion covers all possible errors.
+    Assert(result.ec == std::errc(), "Failed to parse integer.");
+
+    return num;
 }
 
-BytecodeContainer& BytecodeContainer::AddNonimplemented(const std::string& instruction)
+const char* BytecodeInstructionToString(BytecodeInstruction opcode)
 {
-    bytecodeInstructions.push_back(std::string(NOT_IMPLEMENTED) + " | " + instruction);
+    switch (opcode)
+    {
+        case BytecodeInstruction::ILOAD: return ILOAD;
+        case BytecodeInstruction::ICONST: return ICONST;
+        case BytecodeInstruction::ISTORE: return ISTORE;
+        case BytecodeInstruction::GOTO: return GOTO;
+        case BytecodeInstruction::IADD: return IADD;
+        case BytecodeInstruction::ISUB: return ISUB;
+        case BytecodeInstruction::IMUL: return IMUL;
+        case BytecodeInstruction::IDIV: return IDIV;
+        case BytecodeInstruction::INOT: return INOT;
+        case BytecodeInstruction::IAND: return IAND;
+        case BytecodeInstruction::IOR: return IOR;
+        case BytecodeInstruction::IEQ: return IEQ;
+        case BytecodeInstruction::ILT: return ILT;
+        case BytecodeInstruction::IGT: return IGT;
+        case BytecodeInstruction::RETURN: return RETURN;
+        case BytecodeInstruction::IFFALSE: return IFFALSE;
+        case BytecodeInstruction::INVOKEVIRTUAL: return INVOKEVIRTUAL;
+        case BytecodeInstruction::IPRINT: return PRINT;
+        case BytecodeInstruction::STOP: return STOP;
+        default: return NOT_IMPLEMENTED;
+    }
+}
+
+BytecodeContainer& BytecodeContainer::Add(BytecodeInstruction opcode, int32_t operand)
+{
+    bytecodeInstructions.push_back({ opcode, operand });
 
     return *this;
 }
 
-BytecodeContainer& BytecodeContainer::AddLoad(const std::string& symbol)
+BytecodeContainer& BytecodeContainer::AddNonimplemented(const std::string& instruction)
+{
+    return Add(BytecodeInstruction::NULL_INSTRUCTION, Intern(instruction));
+}
+
+BytecodeContainer& BytecodeContainer::AddLoad(Atom symbol)
 {
     // Check if symbol is a literal value. If so, use iconst instruction.
-    if (IsLiteral(symbol))
-    {
-        bytecodeInstructions.push_back(STR_INS(ICONST, symbol));
-    }
-    else
+    const std::string& symbolName = AtomToString(symbol);
+    if (IsLiteral(symbolName))
     {
-        bytecodeInstructions.push_back(STR_INS(ILOAD, symbol));
+        return Add(BytecodeInstruction::ICONST, ParseLiteral(symbolName));
     }
 
-    return *this;
+    return Add(BytecodeInstruction::ILOAD, symbol);
 }
 
-BytecodeContainer& BytecodeContainer::AddOperator(const std::string& op)
+BytecodeContainer& BytecodeContainer::AddOperator(Atom op)
 {
-    bytecodeInstructions.push_back(operatorToInstructionOp.at(op));
-
-    return *this;
+    return Add(operatorToInstructionOp.at(op));
 }
 
-BytecodeContainer& BytecodeContainer::AddStore(const std::string& symbol)
+BytecodeContainer& BytecodeContainer::AddStore(Atom symbol)
 {
-    bytecodeInstructions.push_back(STR_INS(ISTORE, symbol));
-
-    return *this;
+    return Add(BytecodeInstruction::ISTORE, symbol);
 }
 
-BytecodeContainer& BytecodeContainer::AddInvokeVirtual(const std::string& callerName, const std::string& methodName)
+BytecodeContainer& BytecodeContainer::AddInvokeVirtual(Atom callerName, Atom methodName)
 {
-    std::string method = callerName + DOT + methodName;
-    bytecodeInstructions.push_back(STR_INS(INVOKEVIRTUAL, method));
+    // Bind method calls that use keyword "this" to the class of the calling method.
+    Atom callerClass = callerName == Atoms::THIS_KEYWORD ? className : callerName;
 
-    return *this;
+    return Add(BytecodeInstruction::INVOKEVIRTUAL, Intern(AtomToString(callerClass) + DOT + AtomToString(methodName)));
 }
 
 BytecodeContainer& BytecodeContainer::AddReturn()
 {
-    bytecodeInstructions.push_back(RETURN);
-
-    return *this;
+    return Add(BytecodeInstruction::RETURN);
 }
 
-BytecodeContainer& BytecodeContainer::AddJump(const std::string& label)
+BytecodeContainer& BytecodeContainer::AddJump(Atom label)
 {
-    bytecodeInstructions.push_back(STR_INS(GOTO, label));
-
-    return *this;
+    return Add(BytecodeInstruction::GOTO, label);
 }
 
-size_t BytecodeContainer::size()
+const std::string& BytecodeContainer::GetName(int32_t id) const
 {
-    return bytecodeInstructions.size();
+    return AtomToString((Atom)id);
 }
 
-std::string& BytecodeContainer::at(size_t index)
+bool BytecodeContainer::IsMethodLabel(const BytecodeOp& instruction) const
 {
-    return bytecodeInstructions.at(index);
+    return instruction.opcode == BytecodeInstruction::LABEL && methodLabels.count((Atom)instruction.operand) > 0;
 }
 
-void BytecodeContainer::AddMethod(const std::string& className, const std::string& methodName)
+void BytecodeContainer::AddMethod(Atom className, Atom methodName)
 {
-    std::string method = className + DOT + methodName + COLON;
-    AddAny(method);
+    this->className = className;
+
+    Atom label = Intern(AtomToString(className) + DOT + AtomToString(methodName));
+    methodLabels.insert(label);
+
+    Add(BytecodeInstruction::LABEL, label);
 }
 
-void BytecodeContainer::AddBlock(const std::string& label)
+void BytecodeContainer::AddBlock(Atom label)
 {
-    AddAny(label + ":");
+    Add(BytecodeInstruction::LABEL, label);
 }
 
-bool BytecodeContainer::WriteToFile(const std::string& filename)
+void BytecodeContainer::Append(const BytecodeContainer& other)
 {
-    printf("\nGenerating bytecode file...\n");
-
-    std::ofstream file(filename);
-    if (!file.is_open())
-    {
-        PrintError("Failed to open bytecode file for writing.");
-        return false;
-    }
-
-    int indent = 0;
-    for (int i = 0; i < bytecodeInstructions.size(); i++)
-    {
-        const std::string& instruction = bytecodeInstructions[i];
+    Assert(bytecodeInstructions.empty() || localSlotsAssigned == other.localSlotsAssigned,
+        "Cannot append bytecode whose loads and stores refer to variables differently.");
 
-        bool hasColon = StrContains(instruction, COLON);
-        bool hasDot = StrContains(instruction, DOT);
+    bytecodeInstructions.insert(bytecodeInstructions.end(), other.bytecodeInstructions.begin(), other.bytecodeInstructions.end());
+    methodLabels.insert(other.methodLabels.begin(), other.methodLabels.end());
+    localSlotsAssigned = other.localSlotsAssigned;
+}
 
-        bool isMethod = hasColon && hasDot;
-        bool isBlock = hasColon && !hasDot;
+void BytecodeContainer::AssignLocalSlots()
+{
+    // Parameters, local variables and temporaries share one numbering per method.
+    std::unordered_map<int32_t, int32_t> localSlots;
 
-        if (isMethod)
+    for (BytecodeOp& instruction : bytecodeInstructions)
+    {
+        if (IsMethodLabel(instruction))
         {
-            indent = 0;
+            localSlots.clear();
+            continue;
         }
 
-        for (int j = 0; j < indent; j++)
+        if (instruction.opcode != BytecodeInstruction::ILOAD && instruction.opcode != BytecodeInstruction::ISTORE)
         {
-            file << INDENT;
+            continue;
         }
 
-        file << bytecodeInstructions[i] << std::endl;
-
-        // If we encounter a block or method, increase the indent.
-        if (isBlock || isMethod)
-        {
-            indent++;
-        }
-        // If we encounter a goto or return instruction, decrease the indent.
-        else if (bytecodeInstructions[i].find(GOTO) != std::string::npos || bytecodeInstructions[i] == RETURN)
-        {
-            indent--;
-        }
+        auto result = localSlots.emplace(instruction.operand, (int32_t)localSlots.size());
+        instruction.operand = result.first->second;
     }
 
-    printf("Bytecode file generated.\n");
-
-    return true;
-}
-
-void BytecodeContainer::RemoveFirstParams()
-{
-    // Sort the indices in descending order so we can remove them without affecting the rest.
-    std::sort(firstCallParamIndices.begin(), firstCallParamIndices.end(), std::greater<size_t>());
-
-    // Safely remove the first parameter instructions.
-    for (size_t index : firstCallParamIndices)
-    {
-        bytecodeInstructions.erase(bytecodeInstructions.begin() + index);
-    }
+    localSlotsAssigned = true;
 }
@@ -2,38 +2,69 @@
 
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include <unordered_set>
+
+#include "BytecodeDefinitions.h"
+
+// Whether the symbol is an integer or boolean literal.
+bool IsLiteral(const std::string& symbol);
+// The value of an integer or boolean literal.
+int32_t ParseLiteral(const std::string& symbol);
+
+// The textual name of an instruction.
+const char* BytecodeInstructionToString(BytecodeInstruction opcode);
+
+// An instruction as it is generated. The meaning of the operand depends on the opcode:
+// iconst holds the constant, iload/istore hold the atom of their symbol (or their slot once local slots are assigned),
+// labels, goto and iffalse hold the atom of a label, invokevirtual holds the atom of the "[class].[method]" label
+// and not implemented instructions hold the atom of their description.
+struct BytecodeOp
+{
+    BytecodeInstruction opcode;
+    int32_t operand;
+};
 
 struct BytecodeContainer
 {
-    // Combination of iload and iconst instructions.
-    BytecodeContainer& AddAny(const std::string& rawInstruction);
+    BytecodeContainer& Add(BytecodeInstruction opcode, int32_t operand = 0);
     BytecodeContainer& AddNonimplemented(const std::string& instruction);
-    BytecodeContainer& AddLoad(const std::string& symbol);
-    BytecodeContainer& AddOperator(const std::string& op);
-    BytecodeContainer& AddStore(const std::string& symbol);
-    BytecodeContainer& AddInvokeVirtual(const std::string& callerName, const std::string& methodName);
+    // Combination of iload and iconst instructions.
+    BytecodeContainer& AddLoad(Atom symbol);
+    BytecodeContainer& AddOperator(Atom op);
+    BytecodeContainer& AddStore(Atom symbol);
+    BytecodeContainer& AddInvokeVirtual(Atom callerName, Atom methodName);
     BytecodeContainer& AddReturn();
-    BytecodeContainer& AddJump(const std::string& label);
+    BytecodeContainer& AddJump(Atom label);
 
-    void AddMethod(const std::string& className, const std::string& methodName);
-    void AddBlock(const std::string& label);
+    void AddMethod(Atom className, Atom methodName);
+    void AddBlock(Atom label);
 
-    void AddUncondJumpInstruction(const std::string& label);
-    void AddCondJumpInstruction(const std::string& label);
+    // Add the methods of another container after the methods of this one.
+    void Append(const BytecodeContainer& other);
 
-    // Write the bytecode instructions to a file.
-    bool WriteToFile(const std::string& filename);
+    void AddUncondJumpInstruction(Atom label);
+    void AddCondJumpInstruction(Atom label);
 
-    void RemoveFirstParams();
+    // Replace the symbol of every load and store with a slot number local to its method.
+    void AssignLocalSlots();
 
-    size_t size();
-    std::string& at(size_t index);
+    // Get the symbol or label that an operand refers to.
+    const std::string& GetName(int32_t id) const;
 
-    // A container for all the first parameter indices of method calls.
-    // This is needed for deletion when all instructions are generated as they are only relevant to the IR.
-    std::vector<size_t> firstCallParamIndices;
+    // Whether the instruction is the label of a method rather than a block.
+    bool IsMethodLabel(const BytecodeOp& instruction) const;
 
     // A container holding all instructions of a file.
-    std::vector<std::string> bytecodeInstructions;
-};
\ No newline at end of file
+    std::vector<BytecodeOp> bytecodeInstructions;
+
+    // Whether the operands of loads and stores are slots rather than symbol ids.
+    bool localSlotsAssigned = false;
+
+private:
+    // The labels of all methods.
+    std::unordered_set<Atom> methodLabels;
+
+    // The class of the method that is currently being generated.
+    // Method calls that use keyword "this" are bound to this class.
+    Atom className = Atoms::EMPTY;
+};
@@ -1,9 +1,49 @@
 #pragma once
 
-#include "CompilerStringDefines.h"
+#include "Atom.h"
 
 #include <unordered_map>
 #include <string>
+#include <cstdint>
+
+// Threaded dispatch jumps straight from one handler to the next through a table of label addresses.
+// It relies on GCC's labels-as-values extension, so other compilers fall back to a switch.
+// Build with -DUSE_COMPUTED_GOTO=0 to force the switch.
+#ifndef USE_COMPUTED_GOTO
+#if defined(__GNUC__)
+#define USE_COMPUTED_GOTO 1
+#else
+#define USE_COMPUTED_GOTO 0
+#endif
+#endif
+
+// The underlying type is fixed as instructions are stored as is in bytecode files.
+enum class BytecodeInstruction : int32_t
+{
+    ILOAD,
+    ICONST,
+    ISTORE,
+    GOTO,
+    IADD,
+    ISUB,
+    IMUL,
+    IDIV,
+    INOT,
+    IAND,
+    IOR,
+    IEQ,
+    ILT,
+    IGT,
+    ARG,
+    PARAM,
+    RETURN,
+    IFFALSE,
+    INVOKEVIRTUAL,
+    IPRINT,
+    STOP,
+    LABEL,
+    NULL_INSTRUCTION
+};
 
 namespace BytecodeDefinitions
 {
@@ -31,17 +71,17 @@ namespace BytecodeDefinitions
 
     constexpr char NOT_IMPLEMENTED[] = "NOT IMPLEMENTED";
 
-    const static std::unordered_map<std::string, std::string> operatorToInstructionOp = {
-        {O_STR_ADD, IADD},
-        {O_STR_SUB, ISUB},
-        {O_STR_MUL, IMUL},
-        {O_STR_DIV, IDIV},
-        {O_STR_NOT, INOT},
-        {O_STR_AND, IAND},
-        {O_STR_OR, IOR},
-        {O_STR_EQ, IEQ},
-        {O_STR_LT, ILT},
-        {O_STR_GT, IGT}
+    const static std::unordered_map<Atom, BytecodeInstruction> operatorToInstructionOp = {
+        {Atoms::ADD, BytecodeInstruction::IADD},
+        {Atoms::SUB, BytecodeInstruction::ISUB},
+        {Atoms::MUL, BytecodeInstruction::IMUL},
+        {Atoms::DIV, BytecodeInstruction::IDIV},
+        {Atoms::NOT, BytecodeInstruction::INOT},
+        {Atoms::AND, BytecodeInstruction::IAND},
+        {Atoms::OR, BytecodeInstruction::IOR},
+        {Atoms::EQ, BytecodeInstruction::IEQ},
+        {Atoms::LT, BytecodeInstruction::ILT},
+        {Atoms::GT, BytecodeInstruction::IGT}
     };
 
     // Strings for formatting standardization
@@ -1,391 +1,272 @@
 #include "BytecodeInterpreter.h"
 #include "ConsolePrinter.h"
-#include "Utils.h"
-
-#include <charconv>
-#include <fstream>
 
 using namespace BytecodeDefinitions;
 
+#if USE_COMPUTED_GOTO
+#define HANDLER(instruction) HANDLER_##instruction:
+#define DISPATCH() \
+    instruction = &program[programCounter++]; \
+    goto *dispatchTable[(size_t)instruction->opcode];
+#else
+#define HANDLER(instruction) case BytecodeInstruction::instruction:
+#define DISPATCH() break;
+#endif
+
 #define PUSH_BINOP(op) \
-    int rhs = stack.top(); \
-    stack.pop(); \
-    int lhs = stack.top(); \
-    stack.pop(); \
-    stack.push(lhs op rhs);
+    { \
+        int rhs = stack.back(); \
+        stack.pop_back(); \
+        stack.back() = stack.back() op rhs; \
+    }
 
-void BytecodeInterpreter::Interpret(const std::string& filename)
+bool BytecodeInterpreter::Interpret(const std::string& filename)
 {
-    bool readSuccess = ReadFromFile(filename);
+    MappedBytecodeFile file;
+    bool openSuccess = file.Open(filename);
 
-    if (!readSuccess)
+    if (!openSuccess)
     {
         PrintError("Failed to read bytecode file.");
-        return;
+        return false;
     }
 
-    Setup();
-
-    BytecodeInstruction instructionId = BytecodeInstruction::NULL_INSTRUCTION;
-    while (instructionId != BytecodeInstruction::STOP)
-    {
-        std::string instructionStr = GetNextInstruction();
-
-        size_t delimiterIndex = instructionStr.find(DELIMITER);
-        std::string instruction = instructionStr.substr(0, delimiterIndex);
-        instructionId = GetInstructionId(instruction);
-        // TODO: Undefined behaviour if delimiter is not found?
-        std::string_view arg = std::string_view(instructionStr).substr(delimiterIndex + 1);
-
-        switch (instructionId)
-        {
-            case BytecodeInstruction::ILOAD:
-                ExecIload(arg);
-                break;
-
-            case BytecodeInstruction::ICONST:
-                ExecIconst(arg);
-                break;
-
-            case BytecodeInstruction::ISTORE:
-                ExecIstore(arg);
-                break;
-
-            case BytecodeInstruction::GOTO:
-                ExecGoto(arg);
-                break;
-
-            case BytecodeInstruction::IADD:
-                ExecIAdd();
-                break;
-
-            case BytecodeInstruction::ISUB:
-                ExecISub();
-                break;
-
-            case BytecodeInstruction::IMUL:
-                ExecIMul();
-                break;
-
-            case BytecodeInstruction::IDIV:
-                ExecIDiv();
-                break;
-
-            case BytecodeInstruction::INOT:
-                ExecINot();
-                break;
-
-            case BytecodeInstruction::IAND:
-                ExecIAnd();
-                break;
-
-            case BytecodeInstruction::IOR:
-                ExecIOr();
-                break;
-
-            case BytecodeInstruction::IEQ:
-                ExecIEq();
-                break;
+    Setup(file.view);
+    Run();
 
-            case BytecodeInstruction::ILT:
-                ExecILt();
-                break;
-
-            case BytecodeInstruction::IGT:
-                ExecIGt();
-                break;
-
-            case BytecodeInstruction::INVOKEVIRTUAL:
-                ExecInvokeVirtual(arg);
-                break;
-
-            case BytecodeInstruction::RETURN:
-                ExecReturn();
-                break;
-
-            case BytecodeInstruction::IPRINT:
-                ExecIPrint();
-                break;
-
-            case BytecodeInstruction::IFFALSE:
-                ExecIfFalse(arg);
-                break;
-
-            case BytecodeInstruction::STOP:
-                break;
-
-            default:
-                Assert(false, "Invalid instruction.");
-                break;
-        }
-    }
+    return true;
 }
 
-BytecodeInstruction BytecodeInterpreter::GetInstructionId(const std::string& instruction) const
+void BytecodeInterpreter::Interpret(const BytecodeContainer& bytecodeInstructions)
 {
-    static std::unordered_map<std::string, BytecodeInstruction> bytecodeInstructionMap = {
-        { ILOAD, BytecodeInstruction::ILOAD },
-        { ICONST, BytecodeInstruction::ICONST },
-        { ISTORE, BytecodeInstruction::ISTORE },
-        { GOTO, BytecodeInstruction::GOTO },
-        { IADD, BytecodeInstruction::IADD },
-        { ISUB, BytecodeInstruction::ISUB },
-        { IMUL, BytecodeInstruction::IMUL },
-        { IDIV, BytecodeInstruction::IDIV },
-        { INOT, BytecodeInstruction::INOT },
-        { IAND, BytecodeInstruction::IAND },
-        { IOR, BytecodeInstruction::IOR },
-        { IEQ, BytecodeInstruction::IEQ },
-        { ILT, BytecodeInstruction::ILT },
-        { IGT, BytecodeInstruction::IGT },
-        { RETURN, BytecodeInstruction::RETURN },
-        { IFFALSE, BytecodeInstruction::IFFALSE },
-        { INVOKEVIRTUAL, BytecodeInstruction::INVOKEVIRTUAL },
-        { PRINT, BytecodeInstruction::IPRINT },
-        { STOP, BytecodeInstruction::STOP }
-    };
-
-    auto it = bytecodeInstructionMap.find(instruction);
-
-    if (it == bytecodeInstructionMap.end())
-    {
-        return BytecodeInstruction::NULL_INSTRUCTION;
-    }
+    BytecodeProgram bytecodeProgram;
+    bytecodeProgram.Assemble(bytecodeInstructions);
 
-    return it->second;
+    Interpret(bytecodeProgram);
 }
 
-size_t BytecodeInterpreter::FindLabelIndex(const std::string& label) const
+void BytecodeInterpreter::Interpret(const BytecodeProgram& bytecodeProgram)
 {
-    auto it = gotoLabelIndices.find(label);
-
-    Assert(it != gotoLabelIndices.end(), "Label not found.");
-
-    return it->second;
+    // The program outlives the run, so the interpreter can point into it.
+    Setup(bytecodeProgram.GetView());
+    Run();
 }
 
-void BytecodeInterpreter::Setup()
+void BytecodeInterpreter::Run()
 {
-    for (int i = 0; i < instructions.size(); i++)
+    // The state of the current activation is kept in locals while running.
+    size_t programCounter = currentActivation.programCounter;
+    size_t framePointer = currentActivation.framePointer;
+    int* frame = locals.data() + framePointer;
+    const DecodedInstruction* instruction = nullptr;
+
+#if USE_COMPUTED_GOTO
+    // Handler addresses in the same order as BytecodeInstruction.
+    static void* dispatchTable[] = {
+        &&HANDLER_ILOAD,
+        &&HANDLER_ICONST,
+        &&HANDLER_ISTORE,
+        &&HANDLER_GOTO,
+        &&HANDLER_IADD,
+        &&HANDLER_ISUB,
+        &&HANDLER_IMUL,
+        &&HANDLER_IDIV,
+        &&HANDLER_INOT,
+        &&HANDLER_IAND,
+        &&HANDLER_IOR,
+        &&HANDLER_IEQ,
+        &&HANDLER_ILT,
+        &&HANDLER_IGT,
+        &&HANDLER_ARG,
+        &&HANDLER_PARAM,
+        &&HANDLER_RETURN,
+        &&HANDLER_IFFALSE,
+        &&HANDLER_INVOKEVIRTUAL,
+        &&HANDLER_IPRINT,
+        &&HANDLER_STOP,
+        &&HANDLER_LABEL,
+        &&HANDLER_NULL_INSTRUCTION
+    };
+    static_assert(sizeof(dispatchTable) / sizeof(dispatchTable[0]) == (size_t)BytecodeInstruction::NULL_INSTRUCTION + 1,
+        "The dispatch table must have a handler for every instruction.");
+
+    DISPATCH();
+#else
+    while (true)
     {
-        const std::string& instruction = instructions[i];
+        instruction = &program[programCounter++];
 
-        if (instruction.back() == COLON[0])
+        switch (instruction->opcode)
         {
-            std::string label = instruction.substr(0, instruction.size() - 1);
-
-            if (StrContains(label, DOT) && StrContains(label, "main"))
+#endif
+            HANDLER(ILOAD)
             {
-                mainMethodIndex = (size_t)(i + 1); // i + 1 to get the position of the first block.
+                stack.push_back(frame[instruction->operand]);
+                DISPATCH();
             }
 
-            gotoLabelIndices[label] = (size_t)i;
-        }
-    }
-
-    // Set the main method as the current activation.
-    currentActivation.programCounter = mainMethodIndex;
-
-    // Find the class name of the main method.
-    std::string mainFuncLabel = instructions[mainMethodIndex - 1];
-    size_t delimiterIndex = mainFuncLabel.find(DOT);
-    std::string mainClassName = mainFuncLabel.substr(0, delimiterIndex);
-
-    // Set the class name of the main method.
-    currentActivation.className = mainClassName;
-}
-
-bool BytecodeInterpreter::ReadFromFile(const std::string& filename)
-{
-    printf("\nReading bytecode file...\n");
-
-    std::ifstream file(filename);
-    if (!file.is_open())
-    {
-        PrintError("Failed to open bytecode file for reading.");
-        return false;
-    }
-
-    std::string line;
-    while (std::getline(file, line))
-    {
-        // Remove all indentation.
-        line.erase(0, line.find_first_not_of(INDENT));
-
-        instructions.push_back(line);
-    }
-
-    printf("Bytecode file read.\n");
-
-    return true;
-}
-
-std::string BytecodeInterpreter::GetNextInstruction()
-{
-    return instructions[++currentActivation.programCounter];
-}
-
-void BytecodeInterpreter::ExecIload(const std::string_view arg)
-{
-    auto it = currentActivation.variables.find(std::string(arg));
-
-    Assert(it != currentActivation.variables.end(), "Variable not found.");
-
-    stack.push(it->second);
-}
-
-void BytecodeInterpreter::ExecIconst(const std::string_view arg)
-{
-    int num;
-
-    if (arg == "true" || arg == "false")
-    {
-        num = arg == "true" ? 1 : 0;
-        stack.push(num);
-        return;
-    }
+            HANDLER(ICONST)
+            {
+                stack.push_back(instruction->operand);
+                DISPATCH();
+            }
 
-    std::from_chars_result result = std::from_chars(arg.data(), arg.data() + arg.size(), num);
-    // This assertion covers all possible errors.
-    Assert(result.ec == std::errc(), "Failed to parse integer.");
+            HANDLER(ISTORE)
+            {
+                frame[instruction->operand] = stack.back();
+                stack.pop_back();
+                DISPATCH();
+            }
 
-    stack.push(num);
-}
+            HANDLER(GOTO)
+            {
+                // Jump to the first instruction of the block.
+                programCounter = (size_t)instruction->operand;
+                DISPATCH();
+            }
 
-void BytecodeInterpreter::ExecIstore(const std::string_view arg)
-{
-    int value = stack.top();
-    stack.pop();
+            HANDLER(IADD)
+            {
+                PUSH_BINOP(+);
+                DISPATCH();
+            }
 
-    currentActivation.variables[std::string(arg)] = value;
-}
+            HANDLER(ISUB)
+            {
+                PUSH_BINOP(-);
+                DISPATCH();
+            }
 
-void BytecodeInterpreter::ExecGoto(const std::string_view arg)
-{
-    size_t blockIndex = FindLabelIndex(std::string(arg));
+            HANDLER(IMUL)
+            {
+                PUSH_BINOP(*);
+                DISPATCH();
+            }
 
-    // Jump to the block.
-    currentActivation.programCounter = blockIndex;
-}
+            HANDLER(IDIV)
+            {
+                PUSH_BINOP(/);
+                DISPATCH();
+            }
 
-void BytecodeInterpreter::ExecIAdd()
-{
-    PUSH_BINOP(+);
-}
+            HANDLER(INOT)
+            {
+                stack.back() = !stack.back();
+                DISPATCH();
+            }
 
-void BytecodeInterpreter::ExecISub()
-{
-    PUSH_BINOP(-);
-}
+            HANDLER(IAND)
+            {
+                PUSH_BINOP(&&);
+                DISPATCH();
+            }
 
-void BytecodeInterpreter::ExecIMul()
-{
-    PUSH_BINOP(*);
-}
+            HANDLER(IOR)
+            {
+                PUSH_BINOP(||);
+                DISPATCH();
+            }
 
-void BytecodeInterpreter::ExecIDiv()
-{
-    PUSH_BINOP(/ );
-}
+            HANDLER(IEQ)
+            {
+                PUSH_BINOP(==);
+                DISPATCH();
+            }
 
-void BytecodeInterpreter::ExecINot()
-{
-    int value = stack.top();
-    stack.pop();
+            HANDLER(ILT)
+            {
+                PUSH_BINOP(<);
+                DISPATCH();
+            }
 
-    stack.push(!value);
-}
+            HANDLER(IGT)
+            {
+                PUSH_BINOP(>);
+                DISPATCH();
+            }
 
-void BytecodeInterpreter::ExecIAnd()
-{
-    PUSH_BINOP(&&);
-}
+            HANDLER(RETURN)
+            {
+                // Release the frame of the returning activation.
+                locals.resize(framePointer);
+
+                const Activation& caller = activationStack.back();
+                programCounter = caller.programCounter;
+                framePointer = caller.framePointer;
+                frame = locals.data() + framePointer;
+                activationStack.pop_back();
+                DISPATCH();
+            }
 
-void BytecodeInterpreter::ExecIOr()
-{
-    PUSH_BINOP(|| );
-}
+            HANDLER(IFFALSE)
+            {
+                int value = stack.back();
+                stack.pop_back();
+
+                // Otherwise execution falls through to the next instruction.
+                if (value == 0)
+                {
+                    // Use the same logic as GOTO.
+                    programCounter = (size_t)instruction->operand;
+                }
+                DISPATCH();
+            }
 
-void BytecodeInterpreter::ExecIEq()
-{
-    PUSH_BINOP(== );
-}
+            HANDLER(INVOKEVIRTUAL)
+            {
+                int32_t methodId = instruction->operand;
+                Assert(methodId != -1, "Method not found.");
 
-void BytecodeInterpreter::ExecILt()
-{
-    PUSH_BINOP(< );
-}
+                activationStack.push_back({ programCounter, framePointer });
 
-void BytecodeInterpreter::ExecIGt()
-{
-    PUSH_BINOP(> );
-}
+                const MethodInfo& method = methods[methodId];
+                programCounter = method.entry;
 
-void BytecodeInterpreter::ExecReturn()
-{
-    currentActivation = activationStack.top();
-    activationStack.pop();
-}
+                // Allocate a zeroed frame for the new activation on top of the locals stack.
+                framePointer = locals.size();
+                locals.resize(locals.size() + method.frameSize, 0);
+                frame = locals.data() + framePointer;
+                DISPATCH();
+            }
 
-void BytecodeInterpreter::ExecIfFalse(const std::string_view arg)
-{
-    int value = stack.top();
-    stack.pop();
+            HANDLER(IPRINT)
+            {
+                PrintRaw("%d\n", stack.back());
+                stack.pop_back();
+                DISPATCH();
+            }
 
-    if (value == 0)
-    {
-        // Get the goto label.
-        size_t delimiterIndex = arg.find(DELIMITER);
-        std::string_view label = arg.substr(delimiterIndex + 1);
+            HANDLER(STOP)
+            {
+                return;
+            }
 
-        // Use the same logic as GOTO.
-        ExecGoto(label);
-    }
-    else
-    {
-        // Otherwise, offset the program counter by 1 to skip to the next block label.
-        currentActivation.programCounter++;
+            HANDLER(ARG)
+            HANDLER(PARAM)
+            HANDLER(LABEL)
+            HANDLER(NULL_INSTRUCTION)
+            {
+                Assert(false, "Invalid instruction.");
+                return;
+            }
+#if !USE_COMPUTED_GOTO
+        }
     }
+#endif
 }
 
-void BytecodeInterpreter::ExecInvokeVirtual(const std::string_view arg)
+void BytecodeInterpreter::Setup(const BytecodeProgramView& programView)
 {
-    activationStack.push(currentActivation);
-
-    // Initialize new activation record.
-    Activation newActivation = { 0 };
+    program = programView.instructions;
+    methods = programView.methods;
 
-    std::string label = std::string(arg);
-    size_t dotIndex = label.find(DOT);
-    std::string className = label.substr(0, dotIndex);
+    Assert(programView.mainMethodId != -1, "Main method not found.");
+    const MethodInfo& mainMethod = methods[programView.mainMethodId];
 
-    // Get the label index for the new activation record.
-    if (className == "this") // Handle method calls that use keyword "this".
-    {
-        // Create the new label.
-        std::string methodName = label.substr(dotIndex + 1);
-        label = currentActivation.className + DOT + methodName;
-
-        // Keep the class name the same.
-        newActivation.className = currentActivation.className;
-    }
-    else
-    {
-        newActivation.className = className;
-    }
-
-    size_t labelIndex = FindLabelIndex(label);
-    newActivation.programCounter = labelIndex + 1; // +1 to get the position of the first block.
-
-    // Set the new activation record.
-    currentActivation = newActivation;
-}
-
-void BytecodeInterpreter::ExecIPrint()
-{
-    int value = stack.top();
-    stack.pop();
+    // Set the main method as the current activation.
+    currentActivation.programCounter = mainMethod.entry;
+    currentActivation.framePointer = 0;
 
-    printf("%d\n", value);
+    // Allocate the frame of the main method.
+    locals.assign(mainMethod.frameSize, 0);
 }
-
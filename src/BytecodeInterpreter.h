@@ -1,83 +1,42 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
-#include <stack>
+#include <vector>
+#include <cstdint>
 
-#include "BytecodeContainer.h"
+#include "BytecodeProgram.h"
 #include "BytecodeDefinitions.h"
 
-enum class BytecodeInstruction
-{
-    ILOAD,
-    ICONST,
-    ISTORE,
-    GOTO,
-    IADD,
-    ISUB,
-    IMUL,
-    IDIV,
-    INOT,
-    IAND,
-    IOR,
-    IEQ,
-    ILT,
-    IGT,
-    ARG,
-    PARAM,
-    RETURN,
-    IFFALSE,
-    INVOKEVIRTUAL,
-    IPRINT,
-    STOP,
-    NULL_INSTRUCTION
-};
-
 struct Activation
 {
     size_t programCounter;
-    std::string className; // This is used to handle method calls that use keyword "this".
-    std::unordered_map<std::string, int> variables;
+    size_t framePointer; // Index of the first local variable slot of this activation in the locals stack.
 };
 
 struct BytecodeInterpreter
 {
-    void Interpret(const std::string& filename);
+    // Map a bytecode file into memory and run it. Returns false if the file could not be run.
+    bool Interpret(const std::string& filename);
+    // Run generated bytecode directly without going through a file.
+    void Interpret(const BytecodeContainer& bytecodeInstructions);
+    void Interpret(const BytecodeProgram& bytecodeProgram);
 
 private:
-    void Setup();
-    bool ReadFromFile(const std::string& filename);
-    std::string GetNextInstruction();
-
-    void ExecIload(const std::string_view arg);
-    void ExecIconst(const std::string_view arg);
-    void ExecIstore(const std::string_view arg);
-    void ExecGoto(const std::string_view arg);
-    void ExecIAdd();
-    void ExecISub();
-    void ExecIMul();
-    void ExecIDiv();
-    void ExecINot();
-    void ExecIAnd();
-    void ExecIOr();
-    void ExecIEq();
-    void ExecILt();
-    void ExecIGt();
-    void ExecReturn();
-    void ExecIfFalse(const std::string_view arg);
-    void ExecInvokeVirtual(const std::string_view arg);
-    void ExecIPrint();
-
-    BytecodeInstruction GetInstructionId(const std::string& instruction) const;
-    size_t FindLabelIndex(const std::string& label) const;
+    void Setup(const BytecodeProgramView& programView);
+    void Run();
 
 private:
     // Stack for storing the current state of the program.
-    std::stack<int> stack;
-    std::stack<Activation> activationStack;
-    Activation currentActivation = { 0, {} };
-    size_t mainMethodIndex = -1;
-
-    std::vector<std::string> instructions;
-    std::unordered_map<std::string, size_t> gotoLabelIndices;
+    std::vector<int> stack;
+    std::vector<Activation> activationStack;
+    Activation currentActivation = { 0, 0 };
+
+    // The local variables of all activations, stored contiguously.
+    // Each activation owns a fixed size frame starting at its frame pointer.
+    std::vector<int> locals;
+
+    // The decoded instructions with every branch and call target resolved.
+    const DecodedInstruction* program = nullptr;
+    // All methods of the program, indexed by the operand of invokevirtual.
+    const MethodInfo* methods = nullptr;
 };
\ No newline at end of file
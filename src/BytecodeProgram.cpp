@@ -0,0 +1,679 @@
+#include "BytecodeProgram.h"
+#include "BytecodeDefinitions.h"
+#include "ConsolePrinter.h"
+
+#include <algorithm> // std::max, std::min
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace BytecodeDefinitions;
+
+static_assert(sizeof(DecodedInstruction) == 8, "Instructions are stored as is in bytecode files.");
+
+const char* BytecodeProgramView::GetString(uint32_t offset) const
+{
+    Assert(offset < stringPoolSize, "String offset out of range.");
+
+    return stringPool + offset;
+}
+
+bool BytecodeProgramView::WriteDisassembly(const std::string& filename) const
+{
+    PrintRaw("\nGenerating bytecode disassembly file...\n");
+
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        PrintError("Failed to open bytecode disassembly file for writing.");
+        return false;
+    }
+
+    // Method labels share the names of their methods.
+    std::unordered_set<uint32_t> methodNameOffsets;
+    for (uint32_t i = 0; i < methodCount; i++)
+    {
+        methodNameOffsets.insert(methods[i].nameOffset);
+    }
+
+    // Names of branch/call targets by instruction index.
+    std::unordered_map<uint32_t, const char*> targetNames;
+    for (uint32_t i = 0; i < relocationCount; i++)
+    {
+        targetNames[relocations[i].instructionIndex] = GetString(relocations[i].nameOffset);
+    }
+
+    // Labels are stored in the order of the instructions they refer to.
+    uint32_t labelIndex = 0;
+    auto writeLabelsUpTo = [&](uint32_t instructionIndex)
+        {
+            // Methods are not indented, blocks are indented once and instructions twice.
+            for (; labelIndex < labelCount && labels[labelIndex].instructionIndex <= instructionIndex; labelIndex++)
+            {
+                bool isMethod = methodNameOffsets.count(labels[labelIndex].nameOffset) > 0;
+                file << (isMethod ? "" : INDENT) << GetString(labels[labelIndex].nameOffset) << COLON << std::endl;
+            }
+        };
+
+    for (uint32_t i = 0; i < instructionCount; i++)
+    {
+        const DecodedInstruction& instruction = instructions[i];
+
+        writeLabelsUpTo(i);
+
+        file << INDENT << INDENT << BytecodeInstructionToString(instruction.opcode);
+
+        switch (instruction.opcode)
+        {
+            case BytecodeInstruction::ICONST:
+            case BytecodeInstruction::ILOAD:
+            case BytecodeInstruction::ISTORE:
+                file << DELIMITER << instruction.operand;
+                break;
+
+            case BytecodeInstruction::IFFALSE:
+                file << DELIMITER << GOTO << DELIMITER << targetNames[i];
+                break;
+
+            case BytecodeInstruction::GOTO:
+            case BytecodeInstruction::INVOKEVIRTUAL:
+                file << DELIMITER << targetNames[i];
+                break;
+
+            default:
+                break;
+        }
+
+        file << std::endl;
+    }
+    writeLabelsUpTo(instructionCount);
+
+    PrintRaw("Bytecode disassembly file generated.\n");
+
+    return true;
+}
+
+void BytecodeProgram::Assemble(const BytecodeContainer& bytecodeInstructions)
+{
+    const std::vector<BytecodeOp>& generatedInstructions = bytecodeInstructions.bytecodeInstructions;
+    instructions.reserve(generatedInstructions.size());
+
+    // The instruction index of each label and the id of each method, by the name id of their label.
+    std::unordered_map<int32_t, uint32_t> labelIndices;
+    std::unordered_map<int32_t, int32_t> methodIds;
+
+    for (const BytecodeOp& instruction : generatedInstructions)
+    {
+        uint32_t index = (uint32_t)instructions.size();
+
+        switch (instruction.opcode)
+        {
+            // Labels are never executed, so they are left out and refer to the instruction that follows them instead.
+            // Blocks that follow each other then run on without stepping over a label.
+            case BytecodeInstruction::LABEL:
+            {
+                const std::string& label = bytecodeInstructions.GetName(instruction.operand);
+                uint32_t nameOffset = AddString(label);
+                labelIndices[instruction.operand] = index;
+                labels.push_back({ index, nameOffset });
+
+                if (bytecodeInstructions.IsMethodLabel(instruction))
+                {
+                    // Method labels are of the form [class].[method].
+                    if (label.substr(label.find(DOT) + 1) == "main")
+                    {
+                        mainMethodId = (int32_t)methods.size();
+                    }
+
+                    methodIds[instruction.operand] = (int32_t)methods.size();
+                    methods.push_back({ index, 0, nameOffset });
+                }
+                continue;
+            }
+
+            case BytecodeInstruction::ILOAD:
+            case BytecodeInstruction::ISTORE:
+            {
+                Assert(bytecodeInstructions.localSlotsAssigned, "Local slots must be assigned before assembling.");
+
+                // Grow the frame of the method to fit every slot it uses.
+                uint32_t& frameSize = methods.back().frameSize;
+                frameSize = std::max(frameSize, (uint32_t)instruction.operand + 1);
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        instructions.push_back({ instruction.opcode, instruction.operand });
+    }
+
+    // Patch every branch and call site with its resolved target.
+    for (uint32_t i = 0; i < instructions.size(); i++)
+    {
+        DecodedInstruction& instruction = instructions[i];
+        int32_t labelId = instruction.operand;
+
+        if (instruction.opcode == BytecodeInstruction::INVOKEVIRTUAL)
+        {
+            // Calls on callers that could not be resolved during code generation have no target.
+            // These are only reported if they are executed.
+            auto it = methodIds.find(labelId);
+            instruction.operand = it != methodIds.end() ? it->second : -1;
+        }
+        else if (instruction.opcode == BytecodeInstruction::GOTO || instruction.opcode == BytecodeInstruction::IFFALSE)
+        {
+            auto it = labelIndices.find(labelId);
+            Assert(it != labelIndices.end(), "Label not found.");
+
+            instruction.operand = (int32_t)it->second;
+        }
+        else
+        {
+            continue;
+        }
+
+        relocations.push_back({ i, AddString(bytecodeInstructions.GetName(labelId)) });
+    }
+}
+
+bool BytecodeProgram::WriteToFile(const std::string& filename) const
+{
+    PrintRaw("\nGenerating bytecode file...\n");
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        PrintError("Failed to open bytecode file for writing.");
+        return false;
+    }
+
+    BytecodeFileHeader header;
+    memcpy(header.magic, BYTECODE_MAGIC, sizeof(header.magic));
+    header.version = BYTECODE_VERSION;
+    header.mainMethodId = mainMethodId;
+    header.instructionCount = (uint32_t)instructions.size();
+    header.methodCount = (uint32_t)methods.size();
+    header.labelCount = (uint32_t)labels.size();
+    header.relocationCount = (uint32_t)relocations.size();
+    header.stringPoolSize = (uint32_t)stringPool.size();
+
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)instructions.data(), instructions.size() * sizeof(DecodedInstruction));
+    file.write((const char*)methods.data(), methods.size() * sizeof(MethodInfo));
+    file.write((const char*)labels.data(), labels.size() * sizeof(LabelInfo));
+    file.write((const char*)relocations.data(), relocations.size() * sizeof(RelocationInfo));
+    file.write(stringPool.data(), stringPool.size());
+
+    if (!file.good())
+    {
+        PrintError("Failed to write bytecode file.");
+        return false;
+    }
+
+    PrintRaw("Bytecode file generated.\n");
+
+    return true;
+}
+
+BytecodeProgramView BytecodeProgram::GetView() const
+{
+    BytecodeProgramView view;
+    view.instructions = instructions.data();
+    view.instructionCount = (uint32_t)instructions.size();
+    view.methods = methods.data();
+    view.methodCount = (uint32_t)methods.size();
+    view.labels = labels.data();
+    view.labelCount = (uint32_t)labels.size();
+    view.relocations = relocations.data();
+    view.relocationCount = (uint32_t)relocations.size();
+    view.stringPool = stringPool.data();
+    view.stringPoolSize = (uint32_t)stringPool.size();
+    view.mainMethodId = mainMethodId;
+
+    return view;
+}
+
+uint32_t BytecodeProgram::AddString(const std::string& str)
+{
+    auto result = stringOffsets.emplace(str, (uint32_t)stringPool.size());
+
+    // Only new strings are appended, each with its null terminator.
+    if (result.second)
+    {
+        stringPool.append(str);
+        stringPool.push_back('\0');
+    }
+
+    return result.first->second;
+}
+
+// The end of the instructions of a method, which is where the next method starts.
+static uint32_t GetMethodEnd(const BytecodeProgramView& view, uint32_t methodId)
+{
+    return methodId + 1 < view.methodCount ? view.methods[methodId + 1].entry : view.instructionCount;
+}
+
+// Follow every path through a method and check that the operand stack has the same depth whenever an instruction
+// is reached. Depths are relative to the depth the method is entered with, so the arguments pushed by the caller
+// are below zero. paramCounts holds the number of values each method takes off the stack of its caller.
+// Sets lowestDepth to the lowest depth the method reaches, and returnDepth to the depth it returns with or INT32_MIN
+// if it never returns. Returns why the method is invalid, or nullptr if it is valid.
+static const char* CheckStackDepths(const BytecodeProgramView& view, uint32_t methodId, const std::vector<int32_t>& paramCounts,
+    int32_t& lowestDepth, int32_t& returnDepth)
+{
+    uint32_t entry = view.methods[methodId].entry;
+    uint32_t end = GetMethodEnd(view, methodId);
+
+    // The depth before each instruction, or INT32_MIN if no path has reached it yet.
+    std::vector<int32_t> depths(end - entry, INT32_MIN);
+    std::vector<uint32_t> pendingInstructions;
+    const char* error = nullptr;
+    lowestDepth = 0;
+    returnDepth = INT32_MIN;
+
+    auto reach = [&](uint32_t index, int32_t depth)
+        {
+            int32_t& knownDepth = depths[index - entry];
+            if (knownDepth == INT32_MIN)
+            {
+                knownDepth = depth;
+                pendingInstructions.push_back(index);
+            }
+            else if (knownDepth != depth)
+            {
+                error = "operand stack depth differs between paths";
+            }
+        };
+
+    reach(entry, 0);
+    while (!pendingInstructions.empty())
+    {
+        uint32_t index = pendingInstructions.back();
+        pendingInstructions.pop_back();
+
+        const DecodedInstruction& instruction = view.instructions[index];
+        int32_t depth = depths[index - entry];
+        int32_t pops = 0;
+        int32_t pushes = 0;
+        bool fallsThrough = true;
+
+        switch (instruction.opcode)
+        {
+            case BytecodeInstruction::ILOAD:
+            case BytecodeInstruction::ICONST:
+                pushes = 1;
+                break;
+
+            case BytecodeInstruction::ISTORE:
+            case BytecodeInstruction::IPRINT:
+            case BytecodeInstruction::IFFALSE:
+                pops = 1;
+                break;
+
+            case BytecodeInstruction::INOT:
+                pops = 1;
+                pushes = 1;
+                break;
+
+            case BytecodeInstruction::IADD:
+            case BytecodeInstruction::ISUB:
+            case BytecodeInstruction::IMUL:
+            case BytecodeInstruction::IDIV:
+            case BytecodeInstruction::IAND:
+            case BytecodeInstruction::IOR:
+            case BytecodeInstruction::IEQ:
+            case BytecodeInstruction::ILT:
+            case BytecodeInstruction::IGT:
+                pops = 2;
+                pushes = 1;
+                break;
+
+            case BytecodeInstruction::INVOKEVIRTUAL:
+                // A call that could not be resolved stops the program when it is executed.
+                if (instruction.operand == -1)
+                {
+                    fallsThrough = false;
+                }
+                else
+                {
+                    // The called method replaces its arguments with its return value.
+                    pops = paramCounts[instruction.operand];
+                    pushes = 1;
+                }
+                break;
+
+            case BytecodeInstruction::RETURN:
+                if (returnDepth != INT32_MIN && returnDepth != depth)
+                {
+                    error = "operand stack depth differs between returns";
+                }
+                returnDepth = depth;
+                fallsThrough = false;
+                break;
+
+            case BytecodeInstruction::GOTO:
+            case BytecodeInstruction::STOP:
+                fallsThrough = false;
+                break;
+
+            default:
+                break;
+        }
+
+        lowestDepth = std::min(lowestDepth, depth - pops);
+        int32_t nextDepth = depth - pops + pushes;
+
+        // The last instruction of a method never falls through, so the next instruction is in the method.
+        if (fallsThrough)
+        {
+            reach(index + 1, nextDepth);
+        }
+        if (instruction.opcode == BytecodeInstruction::GOTO || instruction.opcode == BytecodeInstruction::IFFALSE)
+        {
+            reach((uint32_t)instruction.operand, nextDepth);
+        }
+    }
+
+    return error;
+}
+
+// Check that a program can be run without reading outside of it. The interpreter trusts every opcode and operand,
+// so a program read from a file is checked once here instead of on every instruction.
+// Returns why the program is invalid, or nullptr if it is valid.
+static const char* ValidateProgram(const BytecodeProgramView& view)
+{
+    // Methods are stored in the order of their instructions and every instruction belongs to the method before it.
+    for (uint32_t i = 0; i < view.methodCount; i++)
+    {
+        const MethodInfo& method = view.methods[i];
+        uint32_t end = GetMethodEnd(view, i);
+
+        if ((i == 0 && method.entry != 0) || method.entry >= end || end > view.instructionCount)
+        {
+            return "method entry out of range";
+        }
+
+        // Every slot is loaded or stored by an instruction of the method.
+        if (method.frameSize > end - method.entry)
+        {
+            return "method frame size out of range";
+        }
+        if (method.nameOffset >= view.stringPoolSize)
+        {
+            return "method name out of range";
+        }
+
+        // Execution continues with the next instruction unless it jumps away, so it must never run out of the method.
+        BytecodeInstruction last = view.instructions[end - 1].opcode;
+        if (last != BytecodeInstruction::GOTO && last != BytecodeInstruction::RETURN && last != BytecodeInstruction::STOP)
+        {
+            return "the last instruction of a method does not leave it";
+        }
+    }
+
+    if (view.instructionCount > 0 && view.methodCount == 0)
+    {
+        return "instructions outside of a method";
+    }
+
+    uint32_t methodId = 0;
+    for (uint32_t i = 0; i < view.instructionCount; i++)
+    {
+        const DecodedInstruction& instruction = view.instructions[i];
+        while (methodId + 1 < view.methodCount && view.methods[methodId + 1].entry <= i)
+        {
+            methodId++;
+        }
+        const MethodInfo& method = view.methods[methodId];
+
+        // The dispatch table is indexed by the opcode.
+        if ((uint32_t)instruction.opcode > (uint32_t)BytecodeInstruction::NULL_INSTRUCTION)
+        {
+            return "invalid opcode";
+        }
+
+        switch (instruction.opcode)
+        {
+            case BytecodeInstruction::ILOAD:
+            case BytecodeInstruction::ISTORE:
+                if (instruction.operand < 0 || (uint32_t)instruction.operand >= method.frameSize)
+                {
+                    return "local variable slot out of range";
+                }
+                break;
+
+            case BytecodeInstruction::GOTO:
+            case BytecodeInstruction::IFFALSE:
+                // A jump into another method would run it with the frame of this one.
+                if (instruction.operand < (int32_t)method.entry || (uint32_t)instruction.operand >= GetMethodEnd(view, methodId))
+                {
+                    return "branch target out of range";
+                }
+                break;
+
+            case BytecodeInstruction::INVOKEVIRTUAL:
+                // Calls that could not be resolved are only reported if they are executed.
+                if (instruction.operand < -1 || instruction.operand >= (int32_t)view.methodCount)
+                {
+                    return "called method out of range";
+                }
+                break;
+
+            // These only exist while the program is generated and can not be executed.
+            case BytecodeInstruction::ARG:
+            case BytecodeInstruction::PARAM:
+            case BytecodeInstruction::LABEL:
+            case BytecodeInstruction::NULL_INSTRUCTION:
+                return "instruction that can not be executed";
+
+            default:
+                break;
+        }
+    }
+
+    // The number of arguments a method takes is the lowest depth it reaches below the depth it was entered with.
+    // That depends on the arguments of the methods it calls, so the methods are checked again until no method
+    // takes more. Until then the depths may be too high, so only the errors of the last round count.
+    std::vector<int32_t> paramCounts(view.methodCount, 0);
+    std::vector<int32_t> returnDepths(view.methodCount, INT32_MIN);
+    const char* stackError = nullptr;
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        stackError = nullptr;
+
+        for (uint32_t i = 0; i < view.methodCount; i++)
+        {
+            int32_t lowestDepth = 0;
+            const char* error = CheckStackDepths(view, i, paramCounts, lowestDepth, returnDepths[i]);
+            stackError = stackError != nullptr ? stackError : error;
+
+            if (-lowestDepth > paramCounts[i])
+            {
+                // Every argument is stored by an instruction of the method.
+                if (-lowestDepth > (int32_t)(GetMethodEnd(view, i) - view.methods[i].entry))
+                {
+                    return "operand stack underflow";
+                }
+
+                paramCounts[i] = -lowestDepth;
+                changed = true;
+            }
+        }
+    }
+
+    if (stackError != nullptr)
+    {
+        return stackError;
+    }
+
+    for (uint32_t i = 0; i < view.methodCount; i++)
+    {
+        // A method leaves its return value in place of its arguments.
+        if (returnDepths[i] != INT32_MIN && returnDepths[i] != 1 - paramCounts[i])
+        {
+            return "method returns with the wrong operand stack depth";
+        }
+    }
+
+    // The main method is entered with an empty stack and has no caller to return to.
+    if (paramCounts[view.mainMethodId] != 0)
+    {
+        return "operand stack underflow";
+    }
+    if (returnDepths[view.mainMethodId] != INT32_MIN)
+    {
+        return "the main method returns";
+    }
+
+    // Labels are stored in the order of their instructions, and may refer to the end of the program.
+    for (uint32_t i = 0; i < view.labelCount; i++)
+    {
+        const LabelInfo& label = view.labels[i];
+        if (label.instructionIndex > view.instructionCount || (i > 0 && label.instructionIndex < view.labels[i - 1].instructionIndex))
+        {
+            return "label out of range";
+        }
+        if (label.nameOffset >= view.stringPoolSize)
+        {
+            return "label name out of range";
+        }
+    }
+
+    for (uint32_t i = 0; i < view.relocationCount; i++)
+    {
+        const RelocationInfo& relocation = view.relocations[i];
+        if (relocation.instructionIndex >= view.instructionCount || relocation.nameOffset >= view.stringPoolSize)
+        {
+            return "relocation out of range";
+        }
+    }
+
+    return nullptr;
+}
+
+MappedBytecodeFile::~MappedBytecodeFile()
+{
+    if (data != nullptr)
+    {
+        munmap(data, size);
+    }
+}
+
+bool MappedBytecodeFile::Open(const std::string& filename)
+{
+    PrintRaw("\nMapping bytecode file...\n");
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        PrintError("Failed to open bytecode file for reading.");
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1 || (size_t)fileStat.st_size < sizeof(BytecodeFileHeader))
+    {
+        PrintError("Bytecode file is too small to be valid.");
+        close(fd);
+        return false;
+    }
+
+    size = (size_t)fileStat.st_size;
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the file is closed.
+    close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        data = nullptr;
+        PrintError("Failed to map bytecode file.");
+        return false;
+    }
+
+    const char* bytes = (const char*)data;
+    const BytecodeFileHeader* header = (const BytecodeFileHeader*)bytes;
+
+    if (memcmp(header->magic, BYTECODE_MAGIC, sizeof(header->magic)) != 0)
+    {
+        PrintError("File is not a bytecode file.");
+        return false;
+    }
+
+    if (header->version != BYTECODE_VERSION)
+    {
+        PrintError("Unsupported bytecode version %u, expected %u.", header->version, BYTECODE_VERSION);
+        return false;
+    }
+
+    // Make sure every section fits in the file before pointing into it.
+    uint64_t expectedSize = sizeof(BytecodeFileHeader)
+        + (uint64_t)header->instructionCount * sizeof(DecodedInstruction)
+        + (uint64_t)header->methodCount * sizeof(MethodInfo)
+        + (uint64_t)header->labelCount * sizeof(LabelInfo)
+        + (uint64_t)header->relocationCount * sizeof(RelocationInfo)
+        + header->stringPoolSize;
+
+    if (expectedSize != size)
+    {
+        PrintError("Bytecode file is truncated or corrupt.");
+        return false;
+    }
+
+    bool validStringPool = header->stringPoolSize == 0 || bytes[size - 1] == '\0';
+    if (!validStringPool)
+    {
+        PrintError("Bytecode file is truncated or corrupt.");
+        return false;
+    }
+
+    // Only a program with a main method can be run.
+    if (header->mainMethodId < 0 || (uint32_t)header->mainMethodId >= header->methodCount)
+    {
+        PrintError("Bytecode file has no main method.");
+        return false;
+    }
+
+    const char* section = bytes + sizeof(BytecodeFileHeader);
+
+    view.instructions = (const DecodedInstruction*)section;
+    view.instructionCount = header->instructionCount;
+    section += header->instructionCount * sizeof(DecodedInstruction);
+
+    view.methods = (const MethodInfo*)section;
+    view.methodCount = header->methodCount;
+    section += header->methodCount * sizeof(MethodInfo);
+
+    view.labels = (const LabelInfo*)section;
+    view.labelCount = header->labelCount;
+    section += header->labelCount * sizeof(LabelInfo);
+
+    view.relocations = (const RelocationInfo*)section;
+    view.relocationCount = header->relocationCount;
+    section += header->relocationCount * sizeof(RelocationInfo);
+
+    view.stringPool = section;
+    view.stringPoolSize = header->stringPoolSize;
+    view.mainMethodId = header->mainMethodId;
+
+    const char* error = ValidateProgram(view);
+    if (error != nullptr)
+    {
+        view = BytecodeProgramView();
+        PrintError("Bytecode file is corrupt: %s.", error);
+        return false;
+    }
+
+    PrintRaw("Bytecode file mapped.\n");
+
+    return true;
+}
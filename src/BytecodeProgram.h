@@ -0,0 +1,122 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+#include "BytecodeContainer.h"
+
+// An instruction that has been decoded once at load time.
+// The meaning of the operand depends on the opcode:
+// iconst holds the constant, iload/istore hold a local variable slot,
+// goto/iffalse hold the index of the first instruction of the target block and invokevirtual holds the id of the called method.
+struct DecodedInstruction
+{
+    BytecodeInstruction opcode;
+    int32_t operand;
+};
+
+struct MethodInfo
+{
+    uint32_t entry; // Index of the first instruction of the method.
+    uint32_t frameSize; // Number of local variable slots used by the method.
+    uint32_t nameOffset; // Offset of the "[class].[method]" label in the string pool.
+};
+
+// Labels are not part of the executed instructions. Each one refers to the instruction that follows it.
+struct LabelInfo
+{
+    uint32_t instructionIndex;
+    uint32_t nameOffset;
+};
+
+// A branch or call site. The operand of the instruction already holds the resolved target,
+// the name of the target is kept for disassembly and for calls that could not be resolved.
+struct RelocationInfo
+{
+    uint32_t instructionIndex;
+    uint32_t nameOffset;
+};
+
+constexpr char BYTECODE_MAGIC[4] = { 'M', 'J', 'B', 'C' };
+// Bump whenever the layout of the file or the meaning of an instruction changes.
+constexpr uint32_t BYTECODE_VERSION = 2;
+
+// Header of a bytecode file. The sections follow the header in the order of the counts below.
+// Every section holds 4 byte aligned records, so all of them can be read in place.
+struct BytecodeFileHeader
+{
+    char magic[4];
+    uint32_t version;
+    int32_t mainMethodId;
+    uint32_t instructionCount;
+    uint32_t methodCount;
+    uint32_t labelCount;
+    uint32_t relocationCount;
+    uint32_t stringPoolSize; // The string pool holds the null terminated names of all labels.
+};
+
+// A read-only program, pointing either into a BytecodeProgram or into a mapped bytecode file.
+struct BytecodeProgramView
+{
+    const char* GetString(uint32_t offset) const;
+
+    // Write the program as readable text.
+    bool WriteDisassembly(const std::string& filename) const;
+
+    const DecodedInstruction* instructions = nullptr;
+    uint32_t instructionCount = 0;
+    const MethodInfo* methods = nullptr;
+    uint32_t methodCount = 0;
+    const LabelInfo* labels = nullptr;
+    uint32_t labelCount = 0;
+    const RelocationInfo* relocations = nullptr;
+    uint32_t relocationCount = 0;
+    const char* stringPool = nullptr;
+    uint32_t stringPoolSize = 0;
+    int32_t mainMethodId = -1;
+};
+
+// A program assembled from generated bytecode with every branch and call target resolved.
+struct BytecodeProgram
+{
+    void Assemble(const BytecodeContainer& bytecodeInstructions);
+
+    // Write the program as a binary bytecode file.
+    bool WriteToFile(const std::string& filename) const;
+
+    BytecodeProgramView GetView() const;
+
+    std::vector<DecodedInstruction> instructions;
+    std::vector<MethodInfo> methods;
+    std::vector<LabelInfo> labels;
+    std::vector<RelocationInfo> relocations;
+    std::string stringPool;
+    int32_t mainMethodId = -1;
+
+private:
+    uint32_t AddString(const std::string& str);
+
+    std::unordered_map<std::string, uint32_t> stringOffsets;
+};
+
+// A bytecode file mapped into memory. The view points straight into the mapping,
+// so the program is executed without copying or parsing it.
+struct MappedBytecodeFile
+{
+    MappedBytecodeFile() = default;
+    ~MappedBytecodeFile();
+
+    MappedBytecodeFile(const MappedBytecodeFile&) = delete;
+    MappedBytecodeFile& operator=(const MappedBytecodeFile&) = delete;
+
+    // Map the file and check every instruction once. Returns false if the file can not be run safely.
+    bool Open(const std::string& filename);
+
+    BytecodeProgramView view;
+
+private:
+    void* data = nullptr;
+    size_t size = 0;
+};
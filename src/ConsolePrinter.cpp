@@ -1,5 +1,48 @@
 #include "ConsolePrinter.h"
 
+#include <cstdio>
+#include <cstdlib>
+
+ConsoleStreams& GetConsoleStreams()
+{
+    static thread_local ConsoleStreams streams;
+    return streams;
+}
+
+void CapturedOutput::Print() const
+{
+    ConsoleStreams& streams = GetConsoleStreams();
+    fwrite(out.data(), 1, out.size(), streams.out);
+    fwrite(err.data(), 1, err.size(), streams.err);
+}
+
+ConsoleCapture::ConsoleCapture(CapturedOutput& output)
+    : output(output), previousStreams(GetConsoleStreams())
+{
+    std::FILE* outStream = open_memstream(&outBuffer, &outSize);
+    std::FILE* errStream = open_memstream(&errBuffer, &errSize);
+    Assert(outStream != nullptr && errStream != nullptr, "Failed to open a stream to capture output in.");
+
+    ConsoleStreams& streams = GetConsoleStreams();
+    streams.out = outStream;
+    streams.err = errStream;
+}
+
+ConsoleCapture::~ConsoleCapture()
+{
+    ConsoleStreams& streams = GetConsoleStreams();
+
+    // Closing the streams makes the buffers hold everything that was printed.
+    fclose(streams.out);
+    fclose(streams.err);
+    streams = previousStreams;
+
+    output.out.append(outBuffer, outSize);
+    output.err.append(errBuffer, errSize);
+    free(outBuffer);
+    free(errBuffer);
+}
+
 void PrintMessage(std::FILE* stream, const char* prefix, const char* format, ...)
 {
     va_list args;
@@ -14,4 +57,3 @@ void PrintMessage(std::FILE* stream, const char* prefix, const char* format, ...
 
     va_end(args);
 }
-
@@ -3,12 +3,62 @@
 #include <iostream>
 #include <cstdarg>
 #include <cassert>
+#include <stdexcept>
+#include <string>
 
-#define PrintRaw(format, ...) PrintMessage(stdout, nullptr, format, ##__VA_ARGS__)
-#define PrintRawErr(format, ...) PrintMessage(stderr, nullptr, format, ##__VA_ARGS__)
-#define PrintError(format, ...) PrintMessage(stderr, "ERROR", format, ##__VA_ARGS__)
-#define PrintLog(format, ...) PrintMessage(stdout, "LOG", format, ##__VA_ARGS__)
+#define PrintRaw(format, ...) PrintMessage(GetConsoleStreams().out, nullptr, format, ##__VA_ARGS__)
+#define PrintRawErr(format, ...) PrintMessage(GetConsoleStreams().err, nullptr, format, ##__VA_ARGS__)
+#define PrintError(format, ...) PrintMessage(GetConsoleStreams().err, "ERROR", format, ##__VA_ARGS__)
+#define PrintLog(format, ...) PrintMessage(GetConsoleStreams().out, "LOG", format, ##__VA_ARGS__)
 
-#define Assert(condition, format, ...) if(!(condition)) { PrintError(format, ##__VA_ARGS__); assert(condition); }
+#define Assert(condition, format, ...) if(!(condition)) { PrintError(format, ##__VA_ARGS__); if(GetConsoleStreams().throwOnAssert) { throw AssertionFailure(#condition); } assert(condition); }
+
+// The streams that the messages of a thread are written to. Every thread has its own,
+// so that jobs running concurrently can each keep their own output and diagnostics.
+struct ConsoleStreams
+{
+    std::FILE* out = stdout;
+    std::FILE* err = stderr;
+
+    // Failed assertions throw an AssertionFailure instead of aborting the process.
+    bool throwOnAssert = false;
+};
+
+struct AssertionFailure : std::runtime_error
+{
+    using std::runtime_error::runtime_error;
+};
+
+ConsoleStreams& GetConsoleStreams();
+
+// Output that was captured instead of printed.
+struct CapturedOutput
+{
+    std::string out;
+    std::string err;
+
+    // Print the captured output to the streams of the calling thread.
+    void Print() const;
+};
+
+// Captures everything the calling thread prints while the capture is alive.
+// This lets work that runs in parallel print its messages in a fixed order afterwards.
+struct ConsoleCapture
+{
+    ConsoleCapture(CapturedOutput& output);
+    ~ConsoleCapture();
+
+    ConsoleCapture(const ConsoleCapture&) = delete;
+    ConsoleCapture& operator=(const ConsoleCapture&) = delete;
+
+private:
+    CapturedOutput& output;
+    ConsoleStreams previousStreams;
+
+    char* outBuffer = nullptr;
+    size_t outSize = 0;
+    char* errBuffer = nullptr;
+    size_t errSize = 0;
+};
 
 void PrintMessage(std::FILE* stream, const char* prefix, const char* format, ...);
@@ -1,10 +1,11 @@
 #include "ControlFlowBlock.h"
+#include "ConsolePrinter.h"
 
 #include <iostream>
 
 void ControlFlowBlock::dump()
 {
-    printf("%s:\n", label.c_str());
+    PrintRaw("%s:\n", AtomCStr(label));
     for (auto& i : instructions)
     {
         i->dump();
@@ -16,7 +17,7 @@ void ControlFlowBlock::AddTAC(TAC* tac)
     instructions.push_back(tac);
 }
 
-std::string ControlFlowBlock::GenerateLabel()
+Atom ControlFlowBlock::GenerateLabel()
 {
-    return "_L" + std::to_string(localTempVarCount++);
+    return Intern("_L" + std::to_string(localTempVarCount++));
 }
@@ -5,21 +5,38 @@
 
 #include "TAC.h"
 
+// Numbers the blocks of one method. Every method has its own numbering, so the graphs of
+// different methods can be built at the same time and their labels stay the same between runs.
+struct BlockNumbering
+{
+    BlockNumbering(Atom methodLabel)
+        : methodLabel(methodLabel)
+    {}
+
+    // The label of the method, of the form [class].[method].
+    Atom methodLabel;
+    int blockCount = 0;
+};
+
 struct ControlFlowBlock
 {
-    ControlFlowBlock() : label("")
+    // Blocks are labelled [class].[method].Block_N so labels are unique across the whole program.
+    ControlFlowBlock(BlockNumbering* numbering)
+        : numbering(numbering)
     {
-        static int blockCount = 0;
-        label = "Block_" + std::to_string(blockCount++);
+        label = Intern(AtomToString(numbering->methodLabel) + ".Block_" + std::to_string(numbering->blockCount++));
     }
 
     void dump();
     void AddTAC(TAC* tac);
-    std::string GenerateLabel();
+    Atom GenerateLabel();
 
-    std::string label;
+    Atom label;
     std::vector<TAC*> instructions;
 
+    // The numbering of the method this block belongs to. New blocks of the method are numbered from it.
+    BlockNumbering* numbering;
+
 private:
     int localTempVarCount = 0;
-};
\ No newline at end of file
+};
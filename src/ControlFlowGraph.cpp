@@ -1,151 +1,155 @@
 #include "ControlFlowGraph.h"
 
-#include <unordered_map>
+#include <array>
 #include <iostream>
 #include <vector>
 
 #include "NodeHelperFunctions.h"
+#include "ConsolePrinter.h"
 
-std::unordered_map<std::string, GenIRExpression> GenIRExpressionMap = {
-    {N_STR_BINARY_OPERATION, GenIRBinaryOp},
-    {N_STR_UNARY_OPERATION, GenIRUnaryOp},
-    {T_STR_BOOLEAN, GenIRLiteral},
-    {T_STR_INT, GenIRLiteral},
-    {T_STR_STRING, GenIRLiteral},
-    {T_STR_ARRAY, GenIRLiteral},
-    {T_STR_THIS, GenIRThis},
-    {N_STR_IDENTIFIER, GenIRIdentifier},
-    {N_STR_NEW_ARR, GenIRNewArray},
-    {N_STR_NEW, GenIRNew},
-    {N_STR_LENGTH, GenIRLength},
-    {N_STR_INDEX, GenIRArrayIndex},
-    {N_STR_METHOD_CALL, GenIRMethodCall}
-};
-
-std::unordered_map<std::string, GenIRStatement> GenIRStatementMap = {
-    {N_STR_STATEMENTS, GenIRStatements},
-    {N_STR_ASSIGNMENT, GenIRAssignment},
-    {N_STR_INDEX_ASSIGNMENT, GenIRArrIndexAssignment},
-    {N_STR_CONDITIONAL_BRANCH, GenIRIfStatement},
-    {N_STR_WHILE, GenIRWhileLoop},
-    {N_STR_SYSTEM_PRINT, GenIRSystemPrint}
-};
+// The IR generator of each expression kind, indexed by node kind.
+static const std::array<GenIRExpression, (size_t)NodeKind::COUNT> GenIRExpressionTable = []
+    {
+        std::array<GenIRExpression, (size_t)NodeKind::COUNT> table = {};
+        table[(size_t)NodeKind::BINARY_OPERATION] = GenIRBinaryOp;
+        table[(size_t)NodeKind::UNARY_OPERATION] = GenIRUnaryOp;
+        table[(size_t)NodeKind::BOOLEAN_LITERAL] = GenIRLiteral;
+        table[(size_t)NodeKind::INT_LITERAL] = GenIRLiteral;
+        table[(size_t)NodeKind::STRING_LITERAL] = GenIRLiteral;
+        table[(size_t)NodeKind::THIS] = GenIRThis;
+        table[(size_t)NodeKind::IDENTIFIER] = GenIRIdentifier;
+        table[(size_t)NodeKind::NEW_ARRAY] = GenIRNewArray;
+        table[(size_t)NodeKind::NEW] = GenIRNew;
+        table[(size_t)NodeKind::LENGTH] = GenIRLength;
+        table[(size_t)NodeKind::INDEX] = GenIRArrayIndex;
+        table[(size_t)NodeKind::METHOD_CALL] = GenIRMethodCall;
+        return table;
+    }();
+
+// The IR generator of each statement kind, indexed by node kind.
+static const std::array<GenIRStatement, (size_t)NodeKind::COUNT> GenIRStatementTable = []
+    {
+        std::array<GenIRStatement, (size_t)NodeKind::COUNT> table = {};
+        table[(size_t)NodeKind::STATEMENTS] = GenIRStatements;
+        table[(size_t)NodeKind::ASSIGNMENT] = GenIRAssignment;
+        table[(size_t)NodeKind::INDEX_ASSIGNMENT] = GenIRArrIndexAssignment;
+        table[(size_t)NodeKind::CONDITIONAL_BRANCH] = GenIRIfStatement;
+        table[(size_t)NodeKind::WHILE] = GenIRWhileLoop;
+        table[(size_t)NodeKind::SYSTEM_PRINT] = GenIRSystemPrint;
+        return table;
+    }();
 
 GenIRExpression GetGenIRExpressionFunc(Node* root)
 {
-    if (root->type == N_STR_EXPRESSION)
-    {
-        return GenIRExpressionMap[root->value];
-    }
-    else
-    {
-        return GenIRExpressionMap[root->type];
-    }
+    GenIRExpression func = GenIRExpressionTable[(size_t)root->kind];
+    Assert(func != nullptr, "No IR generation for expression '%s'.", NodeKindToString(root->kind));
+
+    return func;
 }
 
 GenIRStatement GetGenIRStatementFunc(Node* root)
 {
-    if (root->type == N_STR_STATEMENTS)
-        return GenIRStatementMap[N_STR_STATEMENTS];
+    GenIRStatement func = GenIRStatementTable[(size_t)root->kind];
+    Assert(func != nullptr, "No IR generation for statement '%s'.", NodeKindToString(root->kind));
 
-    return GenIRStatementMap[root->value];
+    return func;
 }
 
 
 // ----- EXPRESSION GENERATION FUNCTIONS START HERE ----- 
 
 
-std::string GenIRBinaryOp(Node* root, ControlFlowNode* blockNode)
+Atom GenIRBinaryOp(Node* root, ControlFlowNode* blockNode)
 {
     Node* leftNode = GetLeftChild(root);
     Node* rightNode = GetRightChild(root);
 
-    std::string lhs_label = GenIRExpression(leftNode, blockNode);
-    std::string rhs_label = GenIRExpression(rightNode, blockNode);
+    Atom lhs_label = GenIRExpression(leftNode, blockNode);
+    Atom rhs_label = GenIRExpression(rightNode, blockNode);
 
-    std::string op = root->value;
+    Atom op = root->value;
 
-    std::string label = blockNode->block.GenerateLabel();
+    Atom label = blockNode->block.GenerateLabel();
     blockNode->AddTAC(new TACExpression(label, lhs_label, op, rhs_label));
 
     return label;
 }
 
-std::string GenIRUnaryOp(Node* root, ControlFlowNode* blockNode)
+Atom GenIRUnaryOp(Node* root, ControlFlowNode* blockNode)
 {
     Node* childNode = GetFirstChild(root);
 
-    std::string child_label = GenIRExpression(childNode, blockNode);
+    Atom child_label = GenIRExpression(childNode, blockNode);
 
-    std::string op = root->value;
+    Atom op = root->value;
 
-    std::string label = blockNode->block.GenerateLabel();
-    blockNode->AddTAC(new TACExpression(label, "", op, child_label));
+    Atom label = blockNode->block.GenerateLabel();
+    blockNode->AddTAC(new TACExpression(label, Atoms::EMPTY, op, child_label));
 
     return label;
 }
 
-std::string GenIRNewArray(Node* root, ControlFlowNode* blockNode)
+Atom GenIRNewArray(Node* root, ControlFlowNode* blockNode)
 {
     // Generate the IR for the size of the array.
     Node* sizeNode = GetFirstChild(root);
-    std::string size_label = GenIRExpression(sizeNode, blockNode);
+    Atom size_label = GenIRExpression(sizeNode, blockNode);
 
-    std::string label = blockNode->block.GenerateLabel();
-    blockNode->AddTAC(new TACNew(label, size_label));
+    Atom label = blockNode->block.GenerateLabel();
+    blockNode->AddTAC(new TACNewArr(label, Atoms::EMPTY, size_label));
 
     return label;
 }
 
-std::string GenIRNew(Node* root, ControlFlowNode* blockNode)
+Atom GenIRNew(Node* root, ControlFlowNode* blockNode)
 {
     Node* identifierNode = GetFirstChild(root);
-    const std::string* identifier = GetIdentifierName(identifierNode);
+    const Atom* identifier = GetIdentifierName(identifierNode);
 
-    std::string label = blockNode->block.GenerateLabel();
+    Atom label = blockNode->block.GenerateLabel();
     blockNode->AddTAC(new TACNew(label, *identifier));
 
     return label;
 }
 
-std::string GenIRLength(Node* root, ControlFlowNode* blockNode)
+Atom GenIRLength(Node* root, ControlFlowNode* blockNode)
 {
     // Generate the IR for the child.
     Node* childNode = GetFirstChild(root);
-    std::string child_label = GenIRExpression(childNode, blockNode);
+    Atom child_label = GenIRExpression(childNode, blockNode);
 
-    std::string label = blockNode->block.GenerateLabel();
+    Atom label = blockNode->block.GenerateLabel();
     blockNode->AddTAC(new TACLength(label, child_label));
 
     return label;
 
 }
 
-std::string GenIRArrayIndex(Node* root, ControlFlowNode* blockNode)
+Atom GenIRArrayIndex(Node* root, ControlFlowNode* blockNode)
 {
     // Generate the IR for the left and right children.
     Node* leftNode = GetLeftChild(root);
     Node* rightNode = GetRightChild(root);
 
-    std::string lhs_label = GenIRExpression(leftNode, blockNode);
-    std::string rhs_label = GenIRExpression(rightNode, blockNode);
+    Atom lhs_label = GenIRExpression(leftNode, blockNode);
+    Atom rhs_label = GenIRExpression(rightNode, blockNode);
 
-    std::string label = blockNode->block.GenerateLabel();
+    Atom label = blockNode->block.GenerateLabel();
     blockNode->AddTAC(new TACArrIndex(label, lhs_label, rhs_label));
 
     return label;
 }
 
-std::string GenIRMethodCall(Node* root, ControlFlowNode* blockNode)
+Atom GenIRMethodCall(Node* root, ControlFlowNode* blockNode)
 {
     Node* callerNode = GetFirstChild(root);
-    std::string caller_label = GenIRExpression(callerNode, blockNode);
+    Atom caller_label = GenIRExpression(callerNode, blockNode);
 
     Node* methodNode = GetChildAtIndex(root, 1);
-    const std::string* method_name = GetIdentifierName(methodNode);
+    const Atom* method_name = GetIdentifierName(methodNode);
 
     Node* argsNode = GetChildAtIndex(root, 2);
-    std::vector<std::string> arg_labels;
+    std::vector<Atom> arg_labels;
     arg_labels.push_back(caller_label); // Add the caller as the first argument.
     if (argsNode != nullptr)
     {
@@ -157,29 +161,31 @@ std::string GenIRMethodCall(Node* root, ControlFlowNode* blockNode)
     }
 
     // Generate the IR for all the arguments.
-    for (auto& arg : arg_labels)
+    TACParam* callerParam = new TACParam(arg_labels[0], true);
+    blockNode->AddTAC(callerParam);
+    for (size_t i = 1; i < arg_labels.size(); i++)
     {
-        blockNode->AddTAC(new TACParam(arg));
+        blockNode->AddTAC(new TACParam(arg_labels[i]));
     }
 
-    std::string label = blockNode->block.GenerateLabel();
-    std::string num_args = std::to_string(arg_labels.size());
-    blockNode->AddTAC(new TACMethodCall(label, *method_name, num_args));
+    Atom label = blockNode->block.GenerateLabel();
+    Atom num_args = Intern(std::to_string(arg_labels.size()));
+    blockNode->AddTAC(new TACMethodCall(label, *method_name, num_args, callerParam));
 
     return label;
 }
 
-std::string GenIRLiteral(Node* root, ControlFlowNode* blockNode)
+Atom GenIRLiteral(Node* root, ControlFlowNode* blockNode)
 {
     return root->value;
 }
 
-std::string GenIRThis(Node* root, ControlFlowNode* blockNode)
+Atom GenIRThis(Node* root, ControlFlowNode* blockNode)
 {
-    return "this";
+    return Atoms::THIS_KEYWORD;
 }
 
-std::string GenIRIdentifier(Node* root, ControlFlowNode* blockNode)
+Atom GenIRIdentifier(Node* root, ControlFlowNode* blockNode)
 {
     return root->value;
 }
@@ -200,10 +206,10 @@ ControlFlowNode* GenIRStatements(Node* root, ControlFlowNode* blockNode)
 ControlFlowNode* GenIRAssignment(Node* root, ControlFlowNode* blockNode)
 {
     Node* rightNode = GetRightChild(root);
-    std::string rhs_label = GenIRExpression(rightNode, blockNode);
+    Atom rhs_label = GenIRExpression(rightNode, blockNode);
 
     Node* leftNode = GetLeftChild(root);
-    const std::string* lhs_label = GetIdentifierName(leftNode);
+    const Atom* lhs_label = GetIdentifierName(leftNode);
 
     blockNode->AddTAC(new TACAssign(*lhs_label, rhs_label));
 
@@ -213,13 +219,13 @@ ControlFlowNode* GenIRAssignment(Node* root, ControlFlowNode* blockNode)
 ControlFlowNode* GenIRArrIndexAssignment(Node* root, ControlFlowNode* blockNode)
 {
     Node* identifierNode = GetFirstChild(root);
-    const std::string* identifier = GetIdentifierName(identifierNode);
+    const Atom* identifier = GetIdentifierName(identifierNode);
 
     Node* indexNode = GetChildAtIndex(root, 1);
-    std::string index_label = GenIRExpression(indexNode, blockNode);
+    Atom index_label = GenIRExpression(indexNode, blockNode);
 
     Node* valueNode = GetChildAtIndex(root, 2);
-    std::string value_label = GenIRExpression(valueNode, blockNode);
+    Atom value_label = GenIRExpression(valueNode, blockNode);
 
     blockNode->AddTAC(new TACAssignIndexed(*identifier, index_label, value_label));
 
@@ -229,15 +235,15 @@ ControlFlowNode* GenIRArrIndexAssignment(Node* root, ControlFlowNode* blockNode)
 ControlFlowNode* GenIRIfStatement(Node* root, ControlFlowNode* blockNode)
 {
     Node* conditionNode = GetFirstChild(root);
-    GenIRExpression(conditionNode, blockNode);
+    blockNode->condition = GenIRExpression(conditionNode, blockNode);
 
-    ControlFlowNode* trueNode = new ControlFlowNode();
+    ControlFlowNode* trueNode = new ControlFlowNode(blockNode->block.numbering);
     blockNode->trueExit = trueNode;
 
-    ControlFlowNode* falseNode = new ControlFlowNode();
+    ControlFlowNode* falseNode = new ControlFlowNode(blockNode->block.numbering);
     blockNode->falseExit = falseNode;
 
-    ControlFlowNode* joinNode = new ControlFlowNode();
+    ControlFlowNode* joinNode = new ControlFlowNode(blockNode->block.numbering);
 
     Node* trueBranchNode = GetChildAtIndex(root, 1);
     trueNode = GenIRStatement(trueBranchNode, trueNode);
@@ -260,15 +266,15 @@ ControlFlowNode* GenIRIfStatement(Node* root, ControlFlowNode* blockNode)
 
 ControlFlowNode* GenIRWhileLoop(Node* root, ControlFlowNode* blockNode)
 {
-    ControlFlowNode* conditionNode = new ControlFlowNode();
+    ControlFlowNode* conditionNode = new ControlFlowNode(blockNode->block.numbering);
 
     Node* conditionExprNode = GetLeftChild(root);
-    GenIRExpression(conditionExprNode, conditionNode);
+    conditionNode->condition = GenIRExpression(conditionExprNode, conditionNode);
 
-    ControlFlowNode* bodyNode = new ControlFlowNode();
+    ControlFlowNode* bodyNode = new ControlFlowNode(blockNode->block.numbering);
     conditionNode->trueExit = bodyNode;
 
-    ControlFlowNode* joinNode = new ControlFlowNode();
+    ControlFlowNode* joinNode = new ControlFlowNode(blockNode->block.numbering);
     conditionNode->falseExit = joinNode;
 
     Node* bodyNodeRoot = GetRightChild(root);
@@ -283,7 +289,7 @@ ControlFlowNode* GenIRWhileLoop(Node* root, ControlFlowNode* blockNode)
 ControlFlowNode* GenIRSystemPrint(Node* root, ControlFlowNode* blockNode)
 {
     Node* childNode = GetFirstChild(root);
-    std::string child_label = GenIRExpression(childNode, blockNode);
+    Atom child_label = GenIRExpression(childNode, blockNode);
 
     blockNode->AddTAC(new TACSystemPrint(child_label));
 
@@ -9,19 +9,19 @@
 #define GenIRStatement(root, blockNode) GetGenIRStatementFunc(root)(root, blockNode)
 #define GenIRExpression(root, blockNode) GetGenIRExpressionFunc(root)(root, blockNode)
 
-std::string GenIRBinaryOp(Node* root, ControlFlowNode* blockNode);
-std::string GenIRUnaryOp(Node* root, ControlFlowNode* blockNode);
-std::string GenIRLiteral(Node* root, ControlFlowNode* blockNode);
-std::string GenIRThis(Node* root, ControlFlowNode* blockNode);
-std::string GenIRIdentifier(Node* root, ControlFlowNode* blockNode);
-std::string GenIRNewArray(Node* root, ControlFlowNode* blockNode);
-std::string GenIRNew(Node* root, ControlFlowNode* blockNode);
-std::string GenIRLength(Node* root, ControlFlowNode* blockNode);
-std::string GenIRArrayIndex(Node* root, ControlFlowNode* blockNode);
-std::string GenIRMethodCall(Node* root, ControlFlowNode* blockNode);
+Atom GenIRBinaryOp(Node* root, ControlFlowNode* blockNode);
+Atom GenIRUnaryOp(Node* root, ControlFlowNode* blockNode);
+Atom GenIRLiteral(Node* root, ControlFlowNode* blockNode);
+Atom GenIRThis(Node* root, ControlFlowNode* blockNode);
+Atom GenIRIdentifier(Node* root, ControlFlowNode* blockNode);
+Atom GenIRNewArray(Node* root, ControlFlowNode* blockNode);
+Atom GenIRNew(Node* root, ControlFlowNode* blockNode);
+Atom GenIRLength(Node* root, ControlFlowNode* blockNode);
+Atom GenIRArrayIndex(Node* root, ControlFlowNode* blockNode);
+Atom GenIRMethodCall(Node* root, ControlFlowNode* blockNode);
 
 // General function pointer for generating IR expressions.
-typedef std::string(*GenIRExpression)(Node* root, ControlFlowNode* blockNode);
+typedef Atom(*GenIRExpression)(Node* root, ControlFlowNode* blockNode);
 GenIRExpression GetGenIRExpressionFunc(Node* root);
 
 ControlFlowNode* GenIRStatements(Node* root, ControlFlowNode* blockNode);
@@ -7,9 +7,12 @@
 #include "ControlFlowGraphHandler.h"
 #include "NodeHelperFunctions.h"
 #include "CompilerStringDefines.h"
+#include "ParallelFor.h"
 
-EntryPoint::EntryPoint(const std::string& _methodName, ControlFlowNode _entryCFGNode, Node* _methodDeclarationNode)
-    : methodName(_methodName), entryCFGNode(_entryCFGNode), methodDeclarationNode(_methodDeclarationNode)
+EntryPoint::EntryPoint(Atom _className, Atom _methodName, Node* _methodDeclarationNode)
+    : className(_className), methodName(_methodName),
+    blockNumbering(std::make_unique<BlockNumbering>(Intern(AtomToString(_className) + BytecodeDefinitions::DOT + AtomToString(_methodName)))),
+    entryCFGNode(blockNumbering.get()), methodDeclarationNode(_methodDeclarationNode)
 {
     Node* params = GetMethodParams(methodDeclarationNode);
     int numParams = (int)GetMethodNumParams(methodDeclarationNode);
@@ -19,69 +22,85 @@ EntryPoint::EntryPoint(const std::string& _methodName, ControlFlowNode _entryCFG
     for (int i = numParams - 1; i >= 0; i--)
     {
         Node* paramNode = GetChildAtIndex(params, i);
-        std::string param = *GetVariableName(paramNode);
+        Atom param = *GetVariableName(paramNode);
         entryCFGNode.AddTAC(new TACArg(param));
     }
 }
 
+CFGHandler::~CFGHandler()
+{
+    for (EntryPoint& entryPoint : methodEntrypoints)
+    {
+        DeleteCFG(&entryPoint.entryCFGNode);
+    }
+}
+
 void CFGHandler::ConstructCFG(SymbolTable* rootST)
 {
     // Firstly setup the entry points for each method.
     Setup(rootST);
 
-    for (auto& classMethodEntry : classMethodEntrypoints)
-    {
-        const std::string& className = classMethodEntry.first;
-        std::vector<EntryPoint>& entryPoints = classMethodEntry.second;
-
-        for (EntryPoint& entryPoint : entryPoints)
-        {
-            bool isMainMethod = entryPoint.methodName == "main";
+    ParallelFor(methodEntrypoints.size(), [&](size_t i) { ConstructMethodCFG(methodEntrypoints[i]); });
+}
 
-            Node* methodDeclarationNode = entryPoint.methodDeclarationNode;
-            Node* methodBodyNode = GetNodeChildWithName(methodDeclarationNode, N_STR_METHOD_BODY);
+void CFGHandler::ConstructMethodCFG(EntryPoint& entryPoint)
+{
+    bool isMainMethod = entryPoint.methodName == Atoms::MAIN;
 
-            ControlFlowNode* currentCFGNode = &entryPoint.entryCFGNode;
-            if (methodBodyNode != nullptr)
-            {
-                for (Node* statement : methodBodyNode->children)
-                {
-                    // Skip variable declarations as these are not instructions.
-                    if (statement->type != N_STR_VARIABLE)
-                    {
-                        currentCFGNode = GenIRStatement(statement, currentCFGNode);
-                    }
-                }
-            }
+    Node* methodDeclarationNode = entryPoint.methodDeclarationNode;
+    Node* methodBodyNode = GetNodeChildWithKind(methodDeclarationNode, NodeKind::METHOD_BODY);
 
-            if (isMainMethod) // Add stop statement to the last node if main method
-            {
-                currentCFGNode->AddTAC(new TACStop());
-            }
-            else // Add return statement to the last node
+    ControlFlowNode* currentCFGNode = &entryPoint.entryCFGNode;
+    if (methodBodyNode != nullptr)
+    {
+        for (Node* statement : methodBodyNode->children)
+        {
+            // Skip variable declarations as these are not instructions.
+            if (statement->kind != NodeKind::VARIABLE)
             {
-                Node* returnExpressionNode = GetReturnNode(methodDeclarationNode);
-                std::string returnExpression = GenIRExpression(returnExpressionNode, currentCFGNode);
-                currentCFGNode->AddTAC(new TACReturn(returnExpression));
+                currentCFGNode = GenIRStatement(statement, currentCFGNode);
             }
         }
     }
+
+    if (isMainMethod) // Add stop statement to the last node if main method
+    {
+        currentCFGNode->AddTAC(new TACStop());
+    }
+    else // Add return statement to the last node
+    {
+        Node* returnExpressionNode = GetReturnNode(methodDeclarationNode);
+        Atom returnExpression = GenIRExpression(returnExpressionNode, currentCFGNode);
+        currentCFGNode->AddTAC(new TACReturn(returnExpression));
+    }
+
+    // Optimize the graph before anything is generated from it.
+    OptimizeMethodCFG(&entryPoint.entryCFGNode, classFields.at(entryPoint.className));
 }
 
 void CFGHandler::Setup(SymbolTable* rootST)
 {
+    size_t methodCount = 0;
+    for (SymbolTable* classTable : rootST->children)
+    {
+        methodCount += classTable->children.size();
+    }
+    methodEntrypoints.reserve(methodCount);
+
     for (SymbolTable* classTable : rootST->children)
     {
-        std::string className = classTable->identifier.symbol.name;
+        Atom className = classTable->identifier.symbol.name;
 
-        for (SymbolTable* methodTable : classTable->children)
+        VariableSet& fields = classFields[className];
+        for (const Identifier& field : classTable->variables)
         {
-            ControlFlowBlock entryBlock = {};
-            ControlFlowNode entryNode(entryBlock);
-            std::string methodName = methodTable->identifier.symbol.name;
-            EntryPoint entryPoint(methodName, entryNode, methodTable->astNode);
+            fields.insert(field.symbol.name);
+        }
 
-            classMethodEntrypoints[className].push_back(std::move(entryPoint));
+        for (SymbolTable* methodTable : classTable->children)
+        {
+            Atom methodName = methodTable->identifier.symbol.name;
+            methodEntrypoints.emplace_back(className, methodName, methodTable->astNode);
         }
     }
 }
@@ -90,12 +109,12 @@ void CFGHandler::Setup(SymbolTable* rootST)
     if (node->exit) \
     { \
         dfs(node->exit); \
-        file << "    \"" << node->block.label << "\" -> \"" << node->exit->block.label << "\" [xlabel=\"" << logicalVal << "\"];\n"; \
+        file << "    \"" << AtomToString(node->block.label) << "\" -> \"" << AtomToString(node->exit->block.label) << "\" [xlabel=\"" << logicalVal << "\"];\n"; \
     }
 
 void CFGHandler::GenerateDOT(const std::string& filename)
 {
-    printf("\nGenerating CFG dot file...\n");
+    PrintRaw("\nGenerating CFG dot file...\n");
 
     {
         std::ofstream file(filename);
@@ -116,10 +135,10 @@ void CFGHandler::GenerateDOT(const std::string& filename)
                 visited.insert(node);
 
                 // Create a label for the node with its instructions
-                file << "    \"" << node->block.label << "\" [label=\"" << node->block.label << "\n";
+                file << "    \"" << AtomToString(node->block.label) << "\" [label=\"" << AtomToString(node->block.label) << "\n";
                 for (const auto& tac : node->block.instructions)
                 {
-                    file << tac->result << " := " << tac->arg1 << " " << tac->op << " " << tac->arg2 << "\\n";
+                    file << AtomToString(tac->result) << " := " << AtomToString(tac->arg1) << " " << AtomToString(tac->op) << " " << AtomToString(tac->arg2) << "\\n";
                 }
                 file << "\"];\n";
 
@@ -130,128 +149,126 @@ void CFGHandler::GenerateDOT(const std::string& filename)
                 AddExitToFile(file, node, falseExit, "False");
             };
 
-        for (auto& classMethodEntry : classMethodEntrypoints)
+        for (EntryPoint& entryPoint : methodEntrypoints)
         {
-            const std::string& className = classMethodEntry.first;
-
-            for (EntryPoint& entryPoint : classMethodEntry.second)
-            {
-                std::string methodLabel = className + "_" + entryPoint.methodName;
+            std::string methodLabel = AtomToString(entryPoint.className) + "_" + AtomToString(entryPoint.methodName);
 
-                // Try to make clear separation between different methods
-                file << "    subgraph cluster_" << methodLabel << " {\n";
-                file << "        label=\"" << methodLabel << "\";\n";
-                dfs(&entryPoint.entryCFGNode);
-                file << "    }\n";
-            }
+            // Try to make clear separation between different methods
+            file << "    subgraph cluster_" << methodLabel << " {\n";
+            file << "        label=\"" << methodLabel << "\";\n";
+            dfs(&entryPoint.entryCFGNode);
+            file << "    }\n";
         }
 
         file << "}\n";
     }
 
-    printf("CFG dot file generated.\n");
+    PrintRaw("CFG dot file generated.\n");
 }
 
 void CFGHandler::GenerateBytecode(BytecodeContainer& bytecodeInstructions)
 {
-    // Recursive lambda function to generate bytecode for all nodes in the CFG.
-    std::function<void(ControlFlowNode*, std::unordered_set<ControlFlowNode*>&)> GenerateBytecodeRecursive = [&]
-    (ControlFlowNode* node, std::unordered_set<ControlFlowNode*>& visitedNodes)
-        {
-            if (visitedNodes.find(node) != visitedNodes.end())
-            {
-                return;
-            }
-
-            visitedNodes.insert(node);
-            node->GenerateBytecode(bytecodeInstructions);
+    // Generate each method into its own container, then join them in the order the methods are declared.
+    std::vector<BytecodeContainer> methodBytecode(methodEntrypoints.size());
+    ParallelFor(methodEntrypoints.size(), [&](size_t i) { GenerateMethodBytecode(methodEntrypoints[i], methodBytecode[i]); });
 
-            if (node->trueExit)
-            {
-                GenerateBytecodeRecursive(node->trueExit, visitedNodes);
-            }
-            if (node->falseExit)
-            {
-                GenerateBytecodeRecursive(node->falseExit, visitedNodes);
-            }
-        };
+    for (const BytecodeContainer& methodInstructions : methodBytecode)
+    {
+        bytecodeInstructions.Append(methodInstructions);
+    }
+}
 
-    for (auto& classMethodEntry : classMethodEntrypoints)
+void CFGHandler::GenerateMethodBytecode(EntryPoint& entryPoint, BytecodeContainer& bytecodeInstructions)
+{
+    // Add method to bytecode.
+    Atom className = entryPoint.className;
+    Atom methodName = entryPoint.methodName;
+    bytecodeInstructions.AddMethod(className, methodName);
+
+    // Special case for main method.
+    // This is because the assignment lets us assume that only local variables are to be used for all blocks.
+    // This is true in all test files except for the main function, which usually calls NEW. 
+    // This fix makes it so the first parameter is set to the class name directly, 
+    // which makes the TAC for calling the class' method correctly insert the label as [class].[method].
+    if (methodName == Atoms::MAIN)
     {
-        for (EntryPoint& entryPoint : classMethodEntry.second)
+        auto& mainInstructions = entryPoint.entryCFGNode.block.instructions;
+
+        // Find the first instruction that is a call.
+        uint32_t newInstructionIndex = (uint32_t)(-1);
+        for (int i = 0; i < mainInstructions.size(); i++)
         {
-            // Add method to bytecode.
-            const std::string& className = classMethodEntry.first;
-            const std::string& methodName = entryPoint.methodName;
-            bytecodeInstructions.AddMethod(className, methodName);
-
-            // Special case for main method.
-            // This is because the assignment lets us assume that only local variables are to be used for all blocks.
-            // This is true in all test files except for the main function, which usually calls NEW. 
-            // This fix makes it so the first parameter is set to the class name directly, 
-            // which makes the TAC for calling the class' method correctly insert the label as [class].[method].
-            if (methodName == "main")
+            TAC* instruction = mainInstructions[i];
+
+            if (instruction->op == Atoms::TAC_CALL)
             {
-                auto& mainInstructions = entryPoint.entryCFGNode.block.instructions;
+                uint32_t nArgs = (uint32_t)std::stoul(AtomToString(instruction->arg2));
+
+                // Find the name of the first param.
+                size_t firstParamIndex = i - nArgs;
+                Atom& firstParam = mainInstructions[firstParamIndex]->result;
 
-                // Find the first instruction that is a call.
-                uint32_t newInstructionIndex = (uint32_t)(-1);
-                for (int i = 0; i < mainInstructions.size(); i++)
+                // Find where first param is declared with new.
+                for (int j = firstParamIndex; j >= 0; j--)
                 {
-                    TAC* instruction = mainInstructions[i];
+                    TAC* paramInstruction = mainInstructions[j];
 
-                    if (instruction->op == "call")
+                    if (paramInstruction->op == Atoms::TAC_NEW)
                     {
-                        uint32_t nArgs = (uint32_t)std::stoul(instruction->arg2);
-
-                        // Find the name of the first param.
-                        size_t firstParamIndex = i - nArgs;
-                        std::string& firstParam = mainInstructions[firstParamIndex]->result;
-
-                        // Find where first param is declared with new.
-                        for (int j = firstParamIndex; j >= 0; j--)
-                        {
-                            TAC* paramInstruction = mainInstructions[j];
+                        newInstructionIndex = j;
 
-                            if (paramInstruction->op == "new")
-                            {
-                                newInstructionIndex = j;
+                        Atom className = paramInstruction->arg2;
 
-                                std::string& className = paramInstruction->arg2;
-
-                                // Change (explicitly override) the name of the first param to the name of the class.
-                                firstParam = className;
-
-                                break;
-                            }
-                        }
+                        // Change (explicitly override) the name of the first param to the name of the class.
+                        firstParam = className;
 
                         break;
                     }
                 }
 
-                // Remove and erase the new instruction.
-                if (newInstructionIndex != (uint32_t)(-1))
-                {
-                    // Delete the instruction.
-                    TACNew* newInstruction = dynamic_cast<TACNew*>(mainInstructions[newInstructionIndex]);
-                    delete newInstruction;
-
-                    // Erase the instruction from the block.
-                    mainInstructions.erase(mainInstructions.begin() + newInstructionIndex);
-                }
+                break;
             }
+        }
+
+        // Remove and erase the new instruction.
+        if (newInstructionIndex != (uint32_t)(-1))
+        {
+            // Delete the instruction.
+            TACNew* newInstruction = dynamic_cast<TACNew*>(mainInstructions[newInstructionIndex]);
+            delete newInstruction;
 
-            // Generate bytecode for all nodes in the CFG.
-            // Keep track of visited nodes to avoid infinite recursion.
-            std::unordered_set<ControlFlowNode*> visitedNodes;
-            GenerateBytecodeRecursive(&entryPoint.entryCFGNode, visitedNodes);
+            // Erase the instruction from the block.
+            mainInstructions.erase(mainInstructions.begin() + newInstructionIndex);
         }
     }
 
+    // Generate bytecode for all nodes in the CFG, in an order that lets as many nodes as possible fall through to their exit.
+    std::vector<ControlFlowNode*> nodes = LayoutNodes(&entryPoint.entryCFGNode);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        ControlFlowNode* nextNode = i + 1 < nodes.size() ? nodes[i + 1] : nullptr;
+        nodes[i]->GenerateBytecode(bytecodeInstructions, nextNode);
+    }
+
+    // Number the variables of the method so the interpreter can use flat frames.
+    bytecodeInstructions.AssignLocalSlots();
+}
 
-    // Finish with safely removing all first parameters from the bytecode instructions.
-    bytecodeInstructions.RemoveFirstParams();
+void CFGHandler::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    for (EntryPoint& entryPoint : methodEntrypoints)
+    {
+        registerInstructions.AddMethod(entryPoint.className, entryPoint.methodName);
 
+        // Uses the same block order as the bytecode.
+        std::vector<ControlFlowNode*> nodes = LayoutNodes(&entryPoint.entryCFGNode);
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            ControlFlowNode* nextNode = i + 1 < nodes.size() ? nodes[i + 1] : nullptr;
+            nodes[i]->GenerateRegisterCode(registerInstructions, nextNode);
+        }
+    }
 
+    // Resolve jumps and calls now that all methods are generated.
+    registerInstructions.Finalize();
 }
@@ -1,30 +1,48 @@
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 #include "ControlFlowGraph.h"
 #include "SymbolTable.h"
+#include "ControlFlowOptimizer.h"
 
 struct EntryPoint
 {
-    EntryPoint() {}
-    EntryPoint(const std::string& _methodName, ControlFlowNode _entryCFGNode, Node* _methodDeclarationNode);
+    EntryPoint(Atom _className, Atom _methodName, Node* _methodDeclarationNode);
 
-    std::string methodName;
+    Atom className;
+    Atom methodName;
+    // Numbers the blocks of the method. Kept on the heap so the blocks can point to it when the entry point moves.
+    std::unique_ptr<BlockNumbering> blockNumbering;
     ControlFlowNode entryCFGNode;
     Node* methodDeclarationNode;
 };
 
 struct CFGHandler
 {
+    CFGHandler() = default;
+    // Deletes the graphs of all methods.
+    ~CFGHandler();
+
+    CFGHandler(const CFGHandler&) = delete;
+    CFGHandler& operator=(const CFGHandler&) = delete;
+
     void ConstructCFG(SymbolTable* rootST);
     void GenerateDOT(const std::string& filename);
     void GenerateBytecode(BytecodeContainer& filename);
+    void GenerateRegisterCode(RegisterContainer& registerInstructions);
 
 private:
     void Setup(SymbolTable* rootST);
 
-    // A map of class names to a vector of entrypoints for each method in the class.
-    std::unordered_map<std::string, std::vector<EntryPoint>> classMethodEntrypoints;
+    // Methods are independent of each other, so these are run for all methods in parallel.
+    void ConstructMethodCFG(EntryPoint& entryPoint);
+    void GenerateMethodBytecode(EntryPoint& entryPoint, BytecodeContainer& bytecodeInstructions);
+
+    // The entry points of all methods, in the order the classes and methods are declared.
+    std::vector<EntryPoint> methodEntrypoints;
+    // The names of the fields of each class.
+    std::unordered_map<Atom, VariableSet> classFields;
 };
\ No newline at end of file
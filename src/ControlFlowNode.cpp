@@ -1,16 +1,17 @@
 #include "ControlFlowNode.h"
 #include "BytecodeDefinitions.h"
+#include "ConsolePrinter.h"
 
 void ControlFlowNode::dump()
 {
     block.dump();
     if (trueExit)
     {
-        printf("True Exit: %s\n", trueExit->block.label.c_str());
+        PrintRaw("True Exit: %s\n", AtomCStr(trueExit->block.label));
     }
     if (falseExit)
     {
-        printf("False Exit: %s\n", falseExit->block.label.c_str());
+        PrintRaw("False Exit: %s\n", AtomCStr(falseExit->block.label));
     }
 }
 
@@ -19,7 +20,7 @@ void ControlFlowNode::AddTAC(TAC* tac)
     block.AddTAC(tac);
 }
 
-void ControlFlowNode::GenerateBytecode(BytecodeContainer& bytecodeInstructions)
+void ControlFlowNode::GenerateBytecode(BytecodeContainer& bytecodeInstructions, const ControlFlowNode* nextNode)
 {
     bytecodeInstructions.AddBlock(block.label);
 
@@ -28,23 +29,39 @@ void ControlFlowNode::GenerateBytecode(BytecodeContainer& bytecodeInstructions)
         tac->GenerateBytecode(bytecodeInstructions);
     }
 
-    if (trueExit && !falseExit)
+    if (trueExit && falseExit)
     {
-        bytecodeInstructions.AddUncondJumpInstruction(trueExit->block.label);
+        // Load the condition onto the stack.
+        bytecodeInstructions.AddLoad(condition);
+
+        // Add the conditional jump instruction.
+        bytecodeInstructions.AddCondJumpInstruction(falseExit->block.label);
     }
-    else if (trueExit && falseExit)
+
+    // The true exit is only jumped to if it does not come right after this node.
+    if (trueExit && trueExit != nextNode)
     {
-        // Make sure to push the latest label to the stack.
-        std::string& last = bytecodeInstructions.bytecodeInstructions.back();
+        bytecodeInstructions.AddUncondJumpInstruction(trueExit->block.label);
+    }
+}
+
+void ControlFlowNode::GenerateRegisterCode(RegisterContainer& registerInstructions, const ControlFlowNode* nextNode)
+{
+    registerInstructions.AddBlock(block.label);
 
-        // Find the label
-        size_t firstDelimiter = last.find(BytecodeDefinitions::DELIMITER);
-        std::string label = last.substr(firstDelimiter + 1);
+    for (TAC* tac : block.instructions)
+    {
+        tac->GenerateRegisterCode(registerInstructions);
+    }
 
-        // Load the label onto the stack.
-        bytecodeInstructions.AddLoad(label);
+    if (trueExit && falseExit)
+    {
+        registerInstructions.AddCondJump(condition, falseExit->block.label);
+    }
 
-        // Add the conditional jump instruction.
-        bytecodeInstructions.AddCondJumpInstruction(falseExit->block.label);
+    // The true exit is only jumped to if it does not come right after this node.
+    if (trueExit && trueExit != nextNode)
+    {
+        registerInstructions.AddJump(trueExit->block.label);
     }
 }
@@ -2,6 +2,7 @@
 
 #include "ControlFlowBlock.h"
 #include "BytecodeContainer.h"
+#include "RegisterContainer.h"
 
 struct ControlFlowNode
 {
@@ -9,8 +10,9 @@ struct ControlFlowNode
         : block(block), trueExit(nullptr), falseExit(nullptr)
     {}
 
-    ControlFlowNode()
-        : block(), trueExit(nullptr), falseExit(nullptr)
+    // Create a node with a new block of the method that numbering belongs to.
+    ControlFlowNode(BlockNumbering* numbering)
+        : block(numbering), trueExit(nullptr), falseExit(nullptr)
     {}
 
     // Dump the contents of this node to stdout.
@@ -20,7 +22,11 @@ struct ControlFlowNode
     void AddTAC(TAC* tac);
 
     // Generate bytecode instructions for this node.
-    void GenerateBytecode(BytecodeContainer& bytecodeInstructions);
+    // nextNode is the node generated right after this one, which is entered by falling through instead of jumping.
+    void GenerateBytecode(BytecodeContainer& bytecodeInstructions, const ControlFlowNode* nextNode);
+
+    // Generate register VM instructions for this node.
+    void GenerateRegisterCode(RegisterContainer& registerInstructions, const ControlFlowNode* nextNode);
     
     // The block for this node.
     ControlFlowBlock block;
@@ -28,4 +34,7 @@ struct ControlFlowNode
     // The true and false branches of this node.
     ControlFlowNode* trueExit;
     ControlFlowNode* falseExit;
+
+    // The symbol holding the branch condition. Only used when the node has both exits.
+    Atom condition = Atoms::EMPTY;
 };
\ No newline at end of file
@@ -0,0 +1,1170 @@
+#include "ControlFlowOptimizer.h"
+#include "BytecodeContainer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+// The variables that hold a known constant at some point of a method.
+// A variable that is missing is not a constant, either because its value is only known at run time
+// or because the paths that lead to the point give it different values.
+typedef std::unordered_map<Atom, int32_t> ConstantMap;
+
+// The nodes that have an exit to each node.
+typedef std::unordered_map<ControlFlowNode*, std::vector<ControlFlowNode*>> PredecessorMap;
+
+static bool IsOperator(Atom op)
+{
+    return op >= Atoms::ADD && op <= Atoms::NOT;
+}
+
+// Whether the instruction assigns a new value to its result. The other instructions only read it, if they use it at all.
+static bool AssignsResult(const TAC* tac)
+{
+    switch (tac->op)
+    {
+        case Atoms::TAC_PARAM:
+        case Atoms::TAC_JUMP:
+        case Atoms::TAC_ASSIGN_INDEXED:
+        case Atoms::TAC_RETURN:
+        case Atoms::TAC_PRINT:
+        case Atoms::TAC_STOP:
+            return false;
+        default:
+            return true;
+    }
+}
+
+// Call func on every symbol the instruction reads. The symbols are passed by reference so they can be replaced.
+template<typename Func>
+static void ForEachOperand(TAC* tac, Func func)
+{
+    switch (tac->op)
+    {
+        case Atoms::TAC_PARAM:
+        case Atoms::TAC_RETURN:
+        case Atoms::TAC_PRINT:
+            func(tac->result);
+            break;
+        case Atoms::TAC_LENGTH:
+        case Atoms::TAC_NEW_ARR:
+            func(tac->arg2);
+            break;
+        case Atoms::TAC_INDEX:
+            func(tac->arg1);
+            func(tac->arg2);
+            break;
+        case Atoms::TAC_ASSIGN_INDEXED:
+            func(tac->result);
+            func(tac->arg1);
+            func(tac->arg2);
+            break;
+        case Atoms::TAC_CALL:
+        case Atoms::TAC_ARG:
+        case Atoms::TAC_JUMP:
+        case Atoms::TAC_NEW:
+        case Atoms::TAC_STOP:
+            break;
+        default:
+            // Assignments and expressions. Unary expressions have no first operand.
+            if (tac->arg1 != Atoms::EMPTY)
+            {
+                func(tac->arg1);
+            }
+            if (IsOperator(tac->op))
+            {
+                func(tac->arg2);
+            }
+            break;
+    }
+}
+
+static Atom ConstantToAtom(int32_t value)
+{
+    return Intern(std::to_string(value));
+}
+
+// Get the value of a symbol if it is a literal or a variable that holds a known constant.
+static bool GetConstant(Atom symbol, const ConstantMap& constants, int32_t& value)
+{
+    if (symbol == Atoms::EMPTY)
+    {
+        return false;
+    }
+
+    auto it = constants.find(symbol);
+    if (it != constants.end())
+    {
+        value = it->second;
+        return true;
+    }
+
+    const std::string& symbolName = AtomToString(symbol);
+    if (IsLiteral(symbolName))
+    {
+        value = ParseLiteral(symbolName);
+        return true;
+    }
+
+    return false;
+}
+
+// Apply a binary operator the same way the interpreters do.
+// Operators the interpreters do not support and divisions that would trap are left for run time.
+static bool FoldOperator(Atom op, int32_t lhs, int32_t rhs, int32_t& result)
+{
+    switch (op)
+    {
+        // Arithmetic wraps around, as it does on the machines the interpreters run on.
+        case Atoms::ADD: result = (int32_t)((uint32_t)lhs + (uint32_t)rhs); return true;
+        case Atoms::SUB: result = (int32_t)((uint32_t)lhs - (uint32_t)rhs); return true;
+        case Atoms::MUL: result = (int32_t)((uint32_t)lhs * (uint32_t)rhs); return true;
+        case Atoms::DIV:
+            if (rhs == 0 || (lhs == INT32_MIN && rhs == -1))
+            {
+                return false;
+            }
+            result = lhs / rhs;
+            return true;
+        case Atoms::AND: result = lhs && rhs; return true;
+        case Atoms::OR: result = lhs || rhs; return true;
+        case Atoms::EQ: result = lhs == rhs; return true;
+        case Atoms::LT: result = lhs < rhs; return true;
+        case Atoms::GT: result = lhs > rhs; return true;
+        default: return false;
+    }
+}
+
+// Get the constant an instruction assigns to its result, if it is known.
+static bool EvaluateInstruction(const TAC* tac, const ConstantMap& constants, int32_t& value)
+{
+    // Plain assignments have no operator.
+    if (tac->op == Atoms::EMPTY)
+    {
+        return GetConstant(tac->arg1, constants, value);
+    }
+
+    if (!IsOperator(tac->op))
+    {
+        return false;
+    }
+
+    int32_t rhs;
+    if (!GetConstant(tac->arg2, constants, rhs))
+    {
+        return false;
+    }
+
+    if (tac->arg1 == Atoms::EMPTY)
+    {
+        if (tac->op != Atoms::NOT)
+        {
+            return false;
+        }
+
+        value = !rhs;
+        return true;
+    }
+
+    int32_t lhs;
+    if (!GetConstant(tac->arg1, constants, lhs))
+    {
+        return false;
+    }
+
+    return FoldOperator(tac->op, lhs, rhs, value);
+}
+
+// Update the constants with the effect of an instruction.
+static void TransferConstants(const TAC* tac, ConstantMap& constants)
+{
+    if (!AssignsResult(tac))
+    {
+        return;
+    }
+
+    int32_t value;
+    if (EvaluateInstruction(tac, constants, value))
+    {
+        constants[tac->result] = value;
+    }
+    else
+    {
+        constants.erase(tac->result);
+    }
+}
+
+// Keep only the constants that both states agree on. Returns whether the state changed.
+static bool MeetConstants(ConstantMap& state, const ConstantMap& incoming)
+{
+    bool changed = false;
+    for (auto it = state.begin(); it != state.end();)
+    {
+        auto other = incoming.find(it->first);
+        if (other == incoming.end() || other->second != it->second)
+        {
+            it = state.erase(it);
+            changed = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    return changed;
+}
+
+// Get the value of the branch condition of a node if it has one and it is known.
+static bool GetConstantCondition(const ControlFlowNode* node, const ConstantMap& constants, int32_t& condition)
+{
+    return node->falseExit && GetConstant(node->condition, constants, condition);
+}
+
+// Replace known constants in the instructions of a node and fold the expressions that only use constants.
+static void RewriteWithConstants(ControlFlowNode* node, ConstantMap constants)
+{
+    for (TAC*& tac : node->block.instructions)
+    {
+        ForEachOperand(tac, [&](Atom& operand)
+            {
+                auto it = constants.find(operand);
+                if (it != constants.end())
+                {
+                    operand = ConstantToAtom(it->second);
+                }
+            });
+
+        int32_t value;
+        if (IsOperator(tac->op) && EvaluateInstruction(tac, constants, value))
+        {
+            Atom result = tac->result;
+            delete tac;
+            tac = new TACAssign(result, ConstantToAtom(value));
+        }
+
+        TransferConstants(tac, constants);
+    }
+
+    int32_t condition;
+    if (GetConstantCondition(node, constants, condition))
+    {
+        // Only the exit selected by the condition is kept, and the node falls through to it.
+        if (!condition)
+        {
+            node->trueExit = node->falseExit;
+        }
+        node->falseExit = nullptr;
+        node->condition = Atoms::EMPTY;
+    }
+}
+
+void PropagateConstants(ControlFlowNode* entryNode)
+{
+    // The constants that hold at the start of every node reached so far.
+    // A node that is not reached yet places no constraints on the constants of its exits.
+    std::unordered_map<ControlFlowNode*, ConstantMap> entryConstants;
+    entryConstants[entryNode];
+
+    std::vector<ControlFlowNode*> worklist = { entryNode };
+    std::unordered_set<ControlFlowNode*> queuedNodes = { entryNode };
+    while (!worklist.empty())
+    {
+        ControlFlowNode* node = worklist.back();
+        worklist.pop_back();
+        queuedNodes.erase(node);
+
+        ConstantMap constants = entryConstants[node];
+        for (const TAC* tac : node->block.instructions)
+        {
+            TransferConstants(tac, constants);
+        }
+
+        // A branch on a known condition only reaches one of its exits.
+        ControlFlowNode* exits[2] = { node->trueExit, node->falseExit };
+        int32_t condition;
+        if (GetConstantCondition(node, constants, condition))
+        {
+            exits[condition ? 1 : 0] = nullptr;
+        }
+
+        for (ControlFlowNode* exit : exits)
+        {
+            if (!exit)
+            {
+                continue;
+            }
+
+            bool changed;
+            auto it = entryConstants.find(exit);
+            if (it == entryConstants.end())
+            {
+                entryConstants.emplace(exit, constants);
+                changed = true;
+            }
+            else
+            {
+                changed = MeetConstants(it->second, constants);
+            }
+
+            if (changed && queuedNodes.insert(exit).second)
+            {
+                worklist.push_back(exit);
+            }
+        }
+    }
+
+    // Every reached node is rewritten. Nodes that were never reached are only entered through branches
+    // on known conditions, so they are cut off from the graph here.
+    for (ControlFlowNode* node : CollectNodes(entryNode))
+    {
+        auto it = entryConstants.find(node);
+        if (it != entryConstants.end())
+        {
+            RewriteWithConstants(node, it->second);
+        }
+    }
+}
+
+// Whether a symbol names a variable rather than a literal.
+static bool IsVariable(Atom symbol)
+{
+    return symbol != Atoms::EMPTY && !IsLiteral(AtomToString(symbol));
+}
+
+// Whether removing the instruction only loses the value it assigns.
+// Divisions are kept unless their divisor is a literal other than zero, since they may trap.
+static bool HasNoSideEffects(const TAC* tac)
+{
+    if (tac->op == Atoms::EMPTY)
+    {
+        return true;
+    }
+
+    if (tac->op == Atoms::DIV)
+    {
+        return !IsVariable(tac->arg2) && ParseLiteral(AtomToString(tac->arg2)) != 0;
+    }
+
+    return IsOperator(tac->op);
+}
+
+// Compute the variables that are live at the end of every node, i.e. that may be read on some path from there
+// before they are assigned again.
+static std::unordered_map<ControlFlowNode*, VariableSet> ComputeLiveOut(const std::vector<ControlFlowNode*>& nodes)
+{
+    // The variables each node reads before assigning them, and the variables it assigns.
+    std::unordered_map<ControlFlowNode*, VariableSet> upwardUses;
+    std::unordered_map<ControlFlowNode*, VariableSet> assigned;
+    for (ControlFlowNode* node : nodes)
+    {
+        VariableSet& uses = upwardUses[node];
+        VariableSet& assigns = assigned[node];
+        auto addUse = [&](Atom& operand)
+            {
+                if (IsVariable(operand) && assigns.count(operand) == 0)
+                {
+                    uses.insert(operand);
+                }
+            };
+
+        for (TAC* tac : node->block.instructions)
+        {
+            ForEachOperand(tac, addUse);
+
+            if (AssignsResult(tac))
+            {
+                assigns.insert(tac->result);
+            }
+        }
+
+        if (node->falseExit)
+        {
+            addUse(node->condition);
+        }
+    }
+
+    std::unordered_map<ControlFlowNode*, VariableSet> liveIn;
+    std::unordered_map<ControlFlowNode*, VariableSet> liveOut;
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+
+        // Nodes are collected in depth first order, so going backwards lets liveness flow against the edges in few rounds.
+        for (auto it = nodes.rbegin(); it != nodes.rend(); ++it)
+        {
+            ControlFlowNode* node = *it;
+
+            VariableSet out;
+            for (ControlFlowNode* exit : { node->trueExit, node->falseExit })
+            {
+                if (exit)
+                {
+                    const VariableSet& exitLiveIn = liveIn[exit];
+                    out.insert(exitLiveIn.begin(), exitLiveIn.end());
+                }
+            }
+
+            VariableSet in = upwardUses[node];
+            const VariableSet& assigns = assigned[node];
+            for (Atom variable : out)
+            {
+                if (assigns.count(variable) == 0)
+                {
+                    in.insert(variable);
+                }
+            }
+
+            if (in != liveIn[node])
+            {
+                liveIn[node] = std::move(in);
+                changed = true;
+            }
+            liveOut[node] = std::move(out);
+        }
+    }
+
+    return liveOut;
+}
+
+// Get the variables that are live right after the last instruction of a node, which includes the branch condition.
+static VariableSet GetLiveAtEnd(ControlFlowNode* node, const std::unordered_map<ControlFlowNode*, VariableSet>& liveOut)
+{
+    VariableSet live = liveOut.at(node);
+    if (node->falseExit && IsVariable(node->condition))
+    {
+        live.insert(node->condition);
+    }
+
+    return live;
+}
+
+// Whether the instruction copies one variable into another.
+static bool IsCopy(const TAC* tac)
+{
+    return tac->op == Atoms::EMPTY && IsVariable(tac->arg1) && tac->arg1 != tac->result;
+}
+
+// Let the instruction that computes a value assign it straight to the variable it is then copied into.
+// This is done when nothing else reads the value, which makes the copy redundant.
+static void CoalesceCopies(ControlFlowNode* node, VariableSet live, const VariableSet& fields)
+{
+    std::vector<TAC*>& instructions = node->block.instructions;
+
+    // Find out which copies read the last value of their source, going backwards from the end of the node.
+    std::vector<bool> sourceDiesAtCopy(instructions.size(), false);
+    for (size_t i = instructions.size(); i-- > 0;)
+    {
+        TAC* tac = instructions[i];
+        if (IsCopy(tac))
+        {
+            sourceDiesAtCopy[i] = live.count(tac->arg1) == 0 && fields.count(tac->arg1) == 0;
+        }
+
+        if (AssignsResult(tac))
+        {
+            live.erase(tac->result);
+        }
+        ForEachOperand(tac, [&](Atom& operand) { live.insert(operand); });
+    }
+
+    // The index of the instruction that last assigned or read each variable.
+    std::unordered_map<Atom, size_t> lastAssigned;
+    std::unordered_map<Atom, size_t> lastRead;
+    bool removed = false;
+    for (size_t i = 0; i < instructions.size(); i++)
+    {
+        TAC* tac = instructions[i];
+
+        if (sourceDiesAtCopy[i])
+        {
+            Atom target = tac->result;
+            Atom source = tac->arg1;
+
+            // The source must be assigned earlier in the node, and neither variable may be touched in between.
+            auto assignment = lastAssigned.find(source);
+            if (assignment != lastAssigned.end())
+            {
+                size_t assignIndex = assignment->second;
+                auto readAfter = [&](Atom variable, size_t index)
+                    {
+                        auto it = lastRead.find(variable);
+                        return it != lastRead.end() && it->second > index;
+                    };
+                auto targetAssigned = lastAssigned.find(target);
+                bool targetTouched = readAfter(target, assignIndex) ||
+                    (targetAssigned != lastAssigned.end() && targetAssigned->second > assignIndex);
+
+                if (!readAfter(source, assignIndex) && !targetTouched)
+                {
+                    instructions[assignIndex]->result = target;
+                    lastAssigned.erase(source);
+                    lastAssigned[target] = assignIndex;
+
+                    delete tac;
+                    instructions[i] = nullptr;
+                    removed = true;
+                    continue;
+                }
+            }
+        }
+
+        ForEachOperand(tac, [&](Atom& operand) { lastRead[operand] = i; });
+        if (AssignsResult(tac))
+        {
+            lastAssigned[tac->result] = i;
+        }
+    }
+
+    if (removed)
+    {
+        instructions.erase(std::remove(instructions.begin(), instructions.end(), nullptr), instructions.end());
+    }
+}
+
+// Replace reads of variables that hold a copy of another variable with that variable.
+static void PropagateLocalCopies(ControlFlowNode* node)
+{
+    // The variables that hold a copy, and the variable each one is a copy of.
+    std::unordered_map<Atom, Atom> copies;
+    auto replaceCopy = [&](Atom& operand)
+        {
+            auto it = copies.find(operand);
+            if (it != copies.end())
+            {
+                operand = it->second;
+            }
+        };
+
+    for (TAC* tac : node->block.instructions)
+    {
+        ForEachOperand(tac, replaceCopy);
+
+        if (!AssignsResult(tac))
+        {
+            continue;
+        }
+
+        // Assigning a variable ends every copy from or into it.
+        for (auto it = copies.begin(); it != copies.end();)
+        {
+            if (it->first == tac->result || it->second == tac->result)
+            {
+                it = copies.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        if (IsCopy(tac))
+        {
+            copies[tac->result] = tac->arg1;
+        }
+    }
+
+    if (node->falseExit)
+    {
+        replaceCopy(node->condition);
+    }
+}
+
+void PropagateCopies(ControlFlowNode* entryNode, const VariableSet& fields)
+{
+    std::vector<ControlFlowNode*> nodes = CollectNodes(entryNode);
+
+    // Both steps only move reads and assignments within a node, so liveness at the ends of the nodes stays the same.
+    std::unordered_map<ControlFlowNode*, VariableSet> liveOut = ComputeLiveOut(nodes);
+    for (ControlFlowNode* node : nodes)
+    {
+        CoalesceCopies(node, GetLiveAtEnd(node, liveOut), fields);
+        PropagateLocalCopies(node);
+    }
+}
+
+// Remove the instructions of a node whose result is never read and is not a field. Returns whether any were removed.
+static bool RemoveDeadInstructions(ControlFlowNode* node, VariableSet live, const VariableSet& fields)
+{
+    std::vector<TAC*>& instructions = node->block.instructions;
+
+    bool removed = false;
+    for (size_t i = instructions.size(); i-- > 0;)
+    {
+        TAC* tac = instructions[i];
+        if (AssignsResult(tac))
+        {
+            if (live.count(tac->result) == 0 && fields.count(tac->result) == 0 && HasNoSideEffects(tac))
+            {
+                delete tac;
+                instructions[i] = nullptr;
+                removed = true;
+                continue;
+            }
+
+            live.erase(tac->result);
+        }
+
+        ForEachOperand(tac, [&](Atom& operand)
+            {
+                if (IsVariable(operand))
+                {
+                    live.insert(operand);
+                }
+            });
+    }
+
+    if (removed)
+    {
+        instructions.erase(std::remove(instructions.begin(), instructions.end(), nullptr), instructions.end());
+    }
+
+    return removed;
+}
+
+bool RemoveDeadStores(ControlFlowNode* entryNode, const VariableSet& fields)
+{
+    // Removing an instruction can make the values it read dead in other nodes, so repeat until nothing changes.
+    bool removedAny = false;
+    bool removed = true;
+    while (removed)
+    {
+        removed = false;
+
+        std::vector<ControlFlowNode*> nodes = CollectNodes(entryNode);
+        std::unordered_map<ControlFlowNode*, VariableSet> liveOut = ComputeLiveOut(nodes);
+        for (ControlFlowNode* node : nodes)
+        {
+            removed |= RemoveDeadInstructions(node, GetLiveAtEnd(node, liveOut), fields);
+        }
+        removedAny |= removed;
+    }
+
+    return removedAny;
+}
+
+// The values known at some point of a method. Every value gets a number, and equal numbers always mean equal values.
+struct ValueTable
+{
+    // The number of the value each variable or literal holds.
+    std::unordered_map<Atom, int> symbolValues;
+
+    // The number of the value of each computed expression. Expressions are keyed on their operator, the numbers
+    // of their operands and, for array reads, the version of memory they read.
+    std::map<std::tuple<Atom, int, int, int>, int> expressionValues;
+
+    // A variable that held each value when it was computed or copied. It is only used while it still holds it.
+    std::unordered_map<int, Atom> valueHolders;
+
+    // Changes whenever an array may be written.
+    int memoryVersion = 0;
+};
+
+static bool IsCommutative(Atom op)
+{
+    return op == Atoms::ADD || op == Atoms::MUL || op == Atoms::AND || op == Atoms::OR || op == Atoms::EQ;
+}
+
+// Whether the instruction may write to an array. Called methods may write to the arrays they are given.
+static bool MayWriteMemory(const TAC* tac)
+{
+    return tac->op == Atoms::TAC_ASSIGN_INDEXED || tac->op == Atoms::TAC_CALL;
+}
+
+static void SetValue(ValueTable& table, Atom symbol, int value)
+{
+    table.symbolValues[symbol] = value;
+
+    // Keep the first variable that holds the value for as long as it does.
+    auto holder = table.valueHolders.find(value);
+    if (holder == table.valueHolders.end())
+    {
+        table.valueHolders.emplace(value, symbol);
+        return;
+    }
+
+    auto holderValue = table.symbolValues.find(holder->second);
+    if (holderValue == table.symbolValues.end() || holderValue->second != value)
+    {
+        holder->second = symbol;
+    }
+}
+
+static int GetValue(ValueTable& table, Atom symbol, int& valueCount)
+{
+    auto it = table.symbolValues.find(symbol);
+    if (it != table.symbolValues.end())
+    {
+        return it->second;
+    }
+
+    // The symbol holds a value that is not known yet, such as a parameter or a literal.
+    int value = valueCount++;
+    SetValue(table, symbol, value);
+
+    return value;
+}
+
+// Get a variable that still holds the value, or EMPTY if none does.
+static Atom GetHolder(const ValueTable& table, int value)
+{
+    auto holder = table.valueHolders.find(value);
+    if (holder == table.valueHolders.end())
+    {
+        return Atoms::EMPTY;
+    }
+
+    auto holderValue = table.symbolValues.find(holder->second);
+    if (holderValue == table.symbolValues.end() || holderValue->second != value)
+    {
+        return Atoms::EMPTY;
+    }
+
+    return holder->second;
+}
+
+// Number the values computed by the instructions of a node, replacing computations of known values with copies.
+static void NumberNodeValues(ControlFlowNode* node, ValueTable& table, int& valueCount)
+{
+    std::vector<TAC*>& instructions = node->block.instructions;
+
+    bool removed = false;
+    for (TAC*& tac : instructions)
+    {
+        bool isExpression = IsOperator(tac->op) || tac->op == Atoms::TAC_INDEX || tac->op == Atoms::TAC_LENGTH;
+        if (isExpression)
+        {
+            int lhs = tac->arg1 != Atoms::EMPTY ? GetValue(table, tac->arg1, valueCount) : -1;
+            int rhs = GetValue(table, tac->arg2, valueCount);
+            if (IsCommutative(tac->op) && rhs < lhs)
+            {
+                std::swap(lhs, rhs);
+            }
+
+            // Only array reads depend on memory. The length of an array never changes.
+            int memoryVersion = tac->op == Atoms::TAC_INDEX ? table.memoryVersion : -1;
+            std::tuple<Atom, int, int, int> key(tac->op, lhs, rhs, memoryVersion);
+
+            auto known = table.expressionValues.find(key);
+            if (known == table.expressionValues.end())
+            {
+                int value = valueCount++;
+                table.expressionValues.emplace(key, value);
+                SetValue(table, tac->result, value);
+                continue;
+            }
+
+            int value = known->second;
+            Atom holder = GetHolder(table, value);
+            if (holder == tac->result)
+            {
+                // The result already holds the value.
+                delete tac;
+                tac = nullptr;
+                removed = true;
+                continue;
+            }
+
+            if (holder != Atoms::EMPTY)
+            {
+                Atom result = tac->result;
+                delete tac;
+                tac = new TACAssign(result, holder);
+            }
+            SetValue(table, tac->result, value);
+        }
+        else if (tac->op == Atoms::EMPTY)
+        {
+            SetValue(table, tac->result, GetValue(table, tac->arg1, valueCount));
+        }
+        else if (AssignsResult(tac))
+        {
+            SetValue(table, tac->result, valueCount++);
+        }
+
+        if (MayWriteMemory(tac))
+        {
+            table.memoryVersion = valueCount++;
+        }
+    }
+
+    if (removed)
+    {
+        instructions.erase(std::remove(instructions.begin(), instructions.end(), nullptr), instructions.end());
+    }
+}
+
+static void CollectPostorderRecursive(ControlFlowNode* node, std::unordered_set<ControlFlowNode*>& visitedNodes, std::vector<ControlFlowNode*>& nodes)
+{
+    if (!node || !visitedNodes.insert(node).second)
+    {
+        return;
+    }
+
+    CollectPostorderRecursive(node->trueExit, visitedNodes, nodes);
+    CollectPostorderRecursive(node->falseExit, visitedNodes, nodes);
+    nodes.push_back(node);
+}
+
+// Compute the immediate dominator of every node, i.e. the closest node that every path from the entry to it passes through.
+// The nodes must be in reverse postorder. The entry is its own dominator.
+// Uses the iterative algorithm of Cooper, Harvey and Kennedy.
+static std::unordered_map<ControlFlowNode*, ControlFlowNode*> ComputeImmediateDominators(const std::vector<ControlFlowNode*>& nodes, const PredecessorMap& predecessors)
+{
+    std::unordered_map<ControlFlowNode*, size_t> orderIndex;
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        orderIndex[nodes[i]] = i;
+    }
+
+    std::unordered_map<ControlFlowNode*, ControlFlowNode*> dominators;
+    dominators[nodes.front()] = nodes.front();
+
+    auto intersect = [&](ControlFlowNode* a, ControlFlowNode* b)
+        {
+            while (a != b)
+            {
+                while (orderIndex[a] > orderIndex[b])
+                {
+                    a = dominators[a];
+                }
+                while (orderIndex[b] > orderIndex[a])
+                {
+                    b = dominators[b];
+                }
+            }
+
+            return a;
+        };
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t i = 1; i < nodes.size(); i++)
+        {
+            ControlFlowNode* node = nodes[i];
+
+            ControlFlowNode* dominator = nullptr;
+            for (ControlFlowNode* predecessor : predecessors.at(node))
+            {
+                if (dominators.count(predecessor) > 0)
+                {
+                    dominator = dominator ? intersect(predecessor, dominator) : predecessor;
+                }
+            }
+
+            auto it = dominators.find(node);
+            if (it == dominators.end() || it->second != dominator)
+            {
+                dominators[node] = dominator;
+                changed = true;
+            }
+        }
+    }
+
+    return dominators;
+}
+
+void NumberValues(ControlFlowNode* entryNode, bool acrossBlocks)
+{
+    int valueCount = 0;
+
+    if (!acrossBlocks)
+    {
+        for (ControlFlowNode* node : CollectNodes(entryNode))
+        {
+            ValueTable table;
+            NumberNodeValues(node, table, valueCount);
+        }
+        return;
+    }
+
+    std::vector<ControlFlowNode*> nodes;
+    std::unordered_set<ControlFlowNode*> visitedNodes;
+    CollectPostorderRecursive(entryNode, visitedNodes, nodes);
+    std::reverse(nodes.begin(), nodes.end());
+
+    PredecessorMap predecessors;
+    for (ControlFlowNode* node : nodes)
+    {
+        predecessors[node];
+        for (ControlFlowNode* exit : { node->trueExit, node->falseExit })
+        {
+            if (exit)
+            {
+                predecessors[exit].push_back(node);
+            }
+        }
+    }
+
+    std::unordered_map<ControlFlowNode*, ControlFlowNode*> dominators = ComputeImmediateDominators(nodes, predecessors);
+
+    // The variables each node assigns, and whether it may write to an array.
+    std::unordered_map<ControlFlowNode*, VariableSet> assigned;
+    std::unordered_set<ControlFlowNode*> writesMemory;
+    for (ControlFlowNode* node : nodes)
+    {
+        VariableSet& assigns = assigned[node];
+        for (const TAC* tac : node->block.instructions)
+        {
+            if (AssignsResult(tac))
+            {
+                assigns.insert(tac->result);
+            }
+            if (MayWriteMemory(tac))
+            {
+                writesMemory.insert(node);
+            }
+        }
+    }
+
+    // Every node starts with the values known at the end of its immediate dominator, which comes before it in reverse postorder.
+    std::unordered_map<ControlFlowNode*, ValueTable> exitTables;
+    for (ControlFlowNode* node : nodes)
+    {
+        ValueTable table;
+        if (node != entryNode)
+        {
+            ControlFlowNode* dominator = dominators.at(node);
+            table = exitTables.at(dominator);
+
+            // The variables are not numbered in SSA form, so values may have changed on the way from the dominator.
+            // Forget every variable that is assigned in a node between the two, found by walking back from this node.
+            std::vector<ControlFlowNode*> worklist = predecessors.at(node);
+            std::unordered_set<ControlFlowNode*> between;
+            while (!worklist.empty())
+            {
+                ControlFlowNode* current = worklist.back();
+                worklist.pop_back();
+                if (current == dominator || !between.insert(current).second)
+                {
+                    continue;
+                }
+
+                for (Atom variable : assigned.at(current))
+                {
+                    table.symbolValues.erase(variable);
+                }
+                if (writesMemory.count(current) > 0)
+                {
+                    table.memoryVersion = valueCount++;
+                }
+
+                const std::vector<ControlFlowNode*>& currentPredecessors = predecessors.at(current);
+                worklist.insert(worklist.end(), currentPredecessors.begin(), currentPredecessors.end());
+            }
+        }
+
+        NumberNodeValues(node, table, valueCount);
+        exitTables.emplace(node, std::move(table));
+    }
+}
+
+// Remove a node that holds no instructions and always goes on to the same exit, by letting the nodes that enter it
+// go to its exit directly. Chains of such nodes are threaded one node at a time. Returns whether the node was removed.
+static bool RemoveEmptyNode(ControlFlowNode* node, const std::vector<ControlFlowNode*>& nodePredecessors)
+{
+    ControlFlowNode* exit = node->trueExit;
+    if (!node->block.instructions.empty() || node->falseExit || !exit || exit == node)
+    {
+        return false;
+    }
+
+    for (ControlFlowNode* predecessor : nodePredecessors)
+    {
+        if (predecessor->trueExit == node)
+        {
+            predecessor->trueExit = exit;
+        }
+        if (predecessor->falseExit == node)
+        {
+            predecessor->falseExit = exit;
+        }
+
+        // A branch whose exits are now the same always goes on to that exit.
+        if (predecessor->falseExit == predecessor->trueExit)
+        {
+            predecessor->falseExit = nullptr;
+            predecessor->condition = Atoms::EMPTY;
+        }
+    }
+
+    delete node;
+    return true;
+}
+
+// Append the exit of a node to it when the node always goes on to that exit and is the only way to enter it.
+// Returns whether the exit was merged.
+static bool MergeWithExit(ControlFlowNode* node, const PredecessorMap& predecessors, const ControlFlowNode* entryNode)
+{
+    ControlFlowNode* exit = node->trueExit;
+    if (node->falseExit || !exit || exit == node || exit == entryNode || predecessors.at(exit).size() != 1)
+    {
+        return false;
+    }
+
+    std::vector<TAC*>& instructions = node->block.instructions;
+    instructions.insert(instructions.end(), exit->block.instructions.begin(), exit->block.instructions.end());
+    exit->block.instructions.clear();
+
+    node->trueExit = exit->trueExit;
+    node->falseExit = exit->falseExit;
+    node->condition = exit->condition;
+
+    delete exit;
+    return true;
+}
+
+void SimplifyCFG(ControlFlowNode* entryNode)
+{
+    // Every change removes a node and its edges, so the graph is simplified one change at a time
+    // until no more changes can be made.
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+
+        std::vector<ControlFlowNode*> nodes = CollectNodes(entryNode);
+        PredecessorMap predecessors;
+        for (ControlFlowNode* node : nodes)
+        {
+            predecessors[node];
+            for (ControlFlowNode* exit : { node->trueExit, node->falseExit })
+            {
+                if (exit)
+                {
+                    predecessors[exit].push_back(node);
+                }
+            }
+        }
+
+        for (ControlFlowNode* node : nodes)
+        {
+            if (MergeWithExit(node, predecessors, entryNode) ||
+                (node != entryNode && RemoveEmptyNode(node, predecessors.at(node))))
+            {
+                changed = true;
+                break;
+            }
+        }
+    }
+}
+
+// Delete a node that is no longer part of the graph, along with its instructions.
+static void DeleteNode(ControlFlowNode* node)
+{
+    for (TAC* tac : node->block.instructions)
+    {
+        delete tac;
+    }
+
+    delete node;
+}
+
+// Delete the nodes that were part of the graph before it was changed and can no longer be reached from its entry.
+static void DeleteUnreachableNodes(ControlFlowNode* entryNode, const std::vector<ControlFlowNode*>& previousNodes)
+{
+    std::vector<ControlFlowNode*> nodes = CollectNodes(entryNode);
+    std::unordered_set<ControlFlowNode*> reachableNodes(nodes.begin(), nodes.end());
+
+    for (ControlFlowNode* node : previousNodes)
+    {
+        if (!reachableNodes.count(node))
+        {
+            DeleteNode(node);
+        }
+    }
+}
+
+void OptimizeMethodCFG(ControlFlowNode* entryNode, const VariableSet& fields)
+{
+    // Folding a branch on a known condition cuts off the nodes that only its other exit reached.
+    std::vector<ControlFlowNode*> nodes = CollectNodes(entryNode);
+    PropagateConstants(entryNode);
+    DeleteUnreachableNodes(entryNode, nodes);
+
+    NumberValues(entryNode);
+    PropagateCopies(entryNode, fields);
+    RemoveDeadStores(entryNode, fields);
+
+    // Branches that were removed leave their conditions unread, and removing those can leave more nodes empty.
+    do
+    {
+        SimplifyCFG(entryNode);
+    } while (RemoveDeadStores(entryNode, fields));
+}
+
+std::vector<ControlFlowNode*> LayoutNodes(ControlFlowNode* entryNode)
+{
+    std::vector<ControlFlowNode*> nodes;
+    std::unordered_set<ControlFlowNode*> placedNodes;
+
+    // The false exits of placed branches, each waiting to start a chain of its own. The latest one is placed first,
+    // so the nodes of a loop body are all placed before the exit of the loop.
+    std::vector<ControlFlowNode*> pendingNodes = { entryNode };
+    while (!pendingNodes.empty())
+    {
+        ControlFlowNode* node = pendingNodes.back();
+        pendingNodes.pop_back();
+
+        // Follow the true exits until one is already placed, so every node of the chain falls through to the next.
+        while (node && placedNodes.insert(node).second)
+        {
+            nodes.push_back(node);
+            if (node->falseExit)
+            {
+                pendingNodes.push_back(node->falseExit);
+            }
+            node = node->trueExit;
+        }
+    }
+
+    return nodes;
+}
+
+static void CollectNodesRecursive(ControlFlowNode* node, std::unordered_set<ControlFlowNode*>& visitedNodes, std::vector<ControlFlowNode*>& nodes)
+{
+    if (!node || !visitedNodes.insert(node).second)
+    {
+        return;
+    }
+
+    nodes.push_back(node);
+    CollectNodesRecursive(node->trueExit, visitedNodes, nodes);
+    CollectNodesRecursive(node->falseExit, visitedNodes, nodes);
+}
+
+std::vector<ControlFlowNode*> CollectNodes(ControlFlowNode* entryNode)
+{
+    std::vector<ControlFlowNode*> nodes;
+    std::unordered_set<ControlFlowNode*> visitedNodes;
+    CollectNodesRecursive(entryNode, visitedNodes, nodes);
+
+    return nodes;
+}
+
+void DeleteCFG(ControlFlowNode* entryNode)
+{
+    for (ControlFlowNode* node : CollectNodes(entryNode))
+    {
+        // The entry node is owned by the caller, only its instructions belong to the graph.
+        if (node == entryNode)
+        {
+            for (TAC* tac : node->block.instructions)
+            {
+                delete tac;
+            }
+            node->block.instructions.clear();
+        }
+        else
+        {
+            DeleteNode(node);
+        }
+    }
+}
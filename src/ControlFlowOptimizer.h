@@ -0,0 +1,46 @@
+#pragma once
+
+#include <unordered_set>
+#include <vector>
+
+#include "ControlFlowNode.h"
+
+// Optimizations over the control flow graph of a single method.
+// They only touch the nodes of the method they are given, so all methods can be optimized at the same time.
+
+// A set of variables, such as the variables that are live at some point of a method.
+typedef std::unordered_set<Atom> VariableSet;
+
+// Run all optimizations on the graph of the method that starts at entryNode. fields are the fields of its class.
+void OptimizeMethodCFG(ControlFlowNode* entryNode, const VariableSet& fields);
+
+// Fold expressions on literals and propagate constants through the graph.
+// Branches on a known condition are turned into unconditional jumps, which cuts off the path that is never taken.
+void PropagateConstants(ControlFlowNode* entryNode);
+
+// Reuse values that were already computed instead of computing them again. Values are numbered within each node and,
+// with acrossBlocks, carried from every node into the nodes it dominates.
+void NumberValues(ControlFlowNode* entryNode, bool acrossBlocks = true);
+
+// Let instructions assign their value straight to the variable it is copied into, and read the original
+// of a copied variable instead of the copy. Fields keep every value that is assigned to them.
+void PropagateCopies(ControlFlowNode* entryNode, const VariableSet& fields);
+
+// Remove instructions that assign a value that is never read, using liveness over the whole graph.
+// Only method locals and temporaries are removed. Stores to the fields are kept, as the method does not see
+// every read of them. Returns whether any instruction was removed.
+bool RemoveDeadStores(ControlFlowNode* entryNode, const VariableSet& fields);
+
+// Merge nodes that always follow each other, and remove nodes that hold no instructions
+// by letting the nodes that enter them jump straight on.
+void SimplifyCFG(ControlFlowNode* entryNode);
+
+// Get the order to generate the nodes in. Every node is followed by its true exit where possible, so it can fall through
+// to it instead of jumping, and the nodes of a loop body are kept together.
+std::vector<ControlFlowNode*> LayoutNodes(ControlFlowNode* entryNode);
+
+// Get all nodes that can be reached from entryNode, in depth first order with the true exit first.
+std::vector<ControlFlowNode*> CollectNodes(ControlFlowNode* entryNode);
+
+// Delete the instructions of every node that can be reached from entryNode, and every such node but entryNode itself.
+void DeleteCFG(ControlFlowNode* entryNode);
@@ -1,32 +1,135 @@
 #ifndef NODE_H
 #define	NODE_H
 
-#include <list>
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <unistd.h>
 #include <sys/wait.h>
 
+#include "Atom.h"
+#include "CompilerStringDefines.h"
+#include "ConsolePrinter.h"
+
 using namespace std;
 
+// The kind of a node, assigned by the parser.
+enum class NodeKind {
+	UNINITIALISED,
+	PROGRAM,
+	MAIN_CLASS,
+	CLASS_DECLS,
+	CLASS_DECL,
+	METHOD_DECLS,
+	METHOD_DECL,
+	METHOD_BODY,
+	RETURN,
+	VARIABLE_DECLS,
+	VARIABLE,
+	PARAMETER_LIST,
+	ARGUMENT_LIST,
+	IDENTIFIER,
+	STATEMENTS,
+
+	// Statements
+	WHILE,
+	SYSTEM_PRINT,
+	ASSIGNMENT,
+	INDEX_ASSIGNMENT,
+	CONDITIONAL_BRANCH,
+
+	// Expressions
+	BINARY_OPERATION,
+	UNARY_OPERATION,
+	NEW_ARRAY,
+	NEW,
+	INDEX,
+	LENGTH,
+	METHOD_CALL,
+	INT_LITERAL,
+	BOOLEAN_LITERAL,
+	STRING_LITERAL,
+	THIS,
+
+	COUNT
+};
+
+// The label of a node kind as it appears in the parse tree.
+inline const char* NodeKindToString(NodeKind kind) {
+	switch (kind) {
+		case NodeKind::PROGRAM: return N_STR_PROGRAM;
+		case NodeKind::MAIN_CLASS: return N_STR_MAIN_CLASS;
+		case NodeKind::CLASS_DECLS: return N_STR_CLASS_DECLS;
+		case NodeKind::CLASS_DECL: return N_STR_CLASS_DECL;
+		case NodeKind::METHOD_DECLS: return N_STR_METHOD_DECLS;
+		case NodeKind::METHOD_DECL: return N_STR_METHOD_DECL;
+		case NodeKind::METHOD_BODY: return N_STR_METHOD_BODY;
+		case NodeKind::RETURN: return N_STR_RETURN;
+		case NodeKind::VARIABLE_DECLS: return N_STR_VARIABLE_DECLS;
+		case NodeKind::VARIABLE: return N_STR_VARIABLE;
+		case NodeKind::PARAMETER_LIST: return N_STR_PARAMETER_LIST;
+		case NodeKind::ARGUMENT_LIST: return N_STR_ARGUMENT_LIST;
+		case NodeKind::IDENTIFIER: return N_STR_IDENTIFIER;
+		case NodeKind::STATEMENTS: return N_STR_STATEMENTS;
+		case NodeKind::WHILE: return N_STR_STATEMENT ":" N_STR_WHILE;
+		case NodeKind::SYSTEM_PRINT: return N_STR_STATEMENT ":" N_STR_SYSTEM_PRINT;
+		case NodeKind::ASSIGNMENT: return N_STR_STATEMENT ":" N_STR_ASSIGNMENT;
+		case NodeKind::INDEX_ASSIGNMENT: return N_STR_STATEMENT ":" N_STR_INDEX_ASSIGNMENT;
+		case NodeKind::CONDITIONAL_BRANCH: return N_STR_STATEMENT ":" N_STR_CONDITIONAL_BRANCH;
+		case NodeKind::BINARY_OPERATION: return N_STR_BINARY_OPERATION;
+		case NodeKind::UNARY_OPERATION: return N_STR_UNARY_OPERATION;
+		case NodeKind::NEW_ARRAY: return N_STR_EXPRESSION ":" N_STR_NEW_ARR;
+		case NodeKind::NEW: return N_STR_EXPRESSION ":" N_STR_NEW;
+		case NodeKind::INDEX: return N_STR_EXPRESSION ":" N_STR_INDEX;
+		case NodeKind::LENGTH: return N_STR_EXPRESSION ":" N_STR_LENGTH;
+		case NodeKind::METHOD_CALL: return N_STR_EXPRESSION ":" N_STR_METHOD_CALL;
+		case NodeKind::INT_LITERAL: return T_STR_INT;
+		case NodeKind::BOOLEAN_LITERAL: return T_STR_BOOLEAN;
+		case NodeKind::STRING_LITERAL: return T_STR_STRING;
+		case NodeKind::THIS: return T_STR_THIS;
+		default: return "uninitialised";
+	}
+}
+
+class Node;
+
+// The children of a node. The child pointers are stored contiguously in the arena that owns the node.
+struct NodeSpan {
+	Node** data = nullptr;
+	size_t count = 0;
+
+	Node** begin() const { return data; }
+	Node** end() const { return data + count; }
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	Node* operator[](size_t index) const { return data[index]; }
+};
 
 class Node {
 public:
 	int id, lineno;
-	string type, value;
-	list<Node*> children;
-	Node(string t, string v, int l) : type(t), value(v), lineno(l){}
+	NodeKind kind;
+	Atom value;
+	NodeSpan children;
+
+	// While parsing, children are linked through the nodes themselves.
+	// The arena lays them out in the span above once parsing is done.
+	Node* firstChild = nullptr;
+	Node* lastChild = nullptr;
+	Node* nextSibling = nullptr;
+	size_t childCount = 0;
+
+	Node(NodeKind k, Atom v, int l) : kind(k), value(v), lineno(l){}
 	Node()
 	{
-		type = "uninitialised";
-		value = "uninitialised"; }   // Bison needs this.
+		kind = NodeKind::UNINITIALISED;
+		value = Atoms::EMPTY; }   // Bison needs this.
   
 	void print_tree(int depth=0) {
 		for(int i=0; i<depth; i++)
 			cout << "  ";
 		
-		cout << type << (value != "" ? ":" : "") << value << endl; //<< " @line: "<< lineno << endl;
+		cout << NodeKindToString(kind) << (value != Atoms::EMPTY ? ":" : "") << AtomToString(value) << endl; //<< " @line: "<< lineno << endl;
 		
 		for(auto i=children.begin(); i != children.end(); i++)
 		{
@@ -44,9 +147,8 @@ public:
 			
 	}
   
-	void generate_tree() {
+	void generate_tree(const std::string& filename = "tree.dot") {
 		std::ofstream outStream;
-		char* filename = "tree.dot";
 	  	outStream.open(filename);
 
 		int count = 0;
@@ -55,12 +157,12 @@ public:
 		outStream << "}" << std::endl;
 		outStream.close();
 
-		printf("\nBuilt a parse-tree at %s. Use 'make tree' to generate the pdf version.\n", filename);
+		PrintRaw("\nBuilt a parse-tree at %s. Use 'make tree' to generate the pdf version.\n", filename.c_str());
   	}
 
   	void generate_tree_content(int &count, ofstream *outStream) {
 	  id = count++;
-	  *outStream << "n" << id << " [label=\"" << type << (value != "" ? ":" : "") << value << "\"];" << endl;
+	  *outStream << "n" << id << " [label=\"" << NodeKindToString(kind) << (value != Atoms::EMPTY ? ":" : "") << AtomToString(value) << "\"];" << endl;
 
 	  for (auto i = children.begin(); i != children.end(); i++)
 	  {
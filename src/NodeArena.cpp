@@ -0,0 +1,78 @@
+#include "NodeArena.h"
+#include "ConsolePrinter.h"
+
+#include <new>
+
+NodeArena::~NodeArena()
+{
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        // Only the last block can be partially used.
+        size_t used = i + 1 == blocks.size() ? blockUsed : NODES_PER_BLOCK;
+
+        for (size_t j = 0; j < used; j++)
+        {
+            blocks[i][j].~Node();
+        }
+
+        ::operator delete(blocks[i]);
+    }
+}
+
+Node* NodeArena::NewNode(NodeKind kind, Atom value, int lineno)
+{
+    if (blockUsed == NODES_PER_BLOCK)
+    {
+        blocks.push_back(static_cast<Node*>(::operator new(sizeof(Node) * NODES_PER_BLOCK)));
+        blockUsed = 0;
+    }
+
+    Node* node = blocks.back() + blockUsed++;
+
+    return new (node) Node(kind, value, lineno);
+}
+
+void NodeArena::AddChild(Node* parent, Node* child)
+{
+    Assert(childStorage.empty(), "Children can not be added after the arena is finalized.");
+
+    if (parent->lastChild == nullptr)
+    {
+        parent->firstChild = child;
+    }
+    else
+    {
+        parent->lastChild->nextSibling = child;
+    }
+
+    parent->lastChild = child;
+    parent->childCount++;
+    totalChildren++;
+}
+
+void NodeArena::Finalize(Node* root)
+{
+    // Reserving every child up front keeps the spans valid while the storage is filled.
+    childStorage.reserve(totalChildren);
+
+    std::vector<Node*> nodeStack = { root };
+    while (!nodeStack.empty())
+    {
+        Node* node = nodeStack.back();
+        nodeStack.pop_back();
+
+        node->children.data = childStorage.data() + childStorage.size();
+        node->children.count = node->childCount;
+
+        for (Node* child = node->firstChild; child != nullptr; child = child->nextSibling)
+        {
+            childStorage.push_back(child);
+        }
+
+        // Push in reverse so the children are visited in order.
+        for (size_t i = node->children.size(); i > 0; i--)
+        {
+            nodeStack.push_back(node->children[i - 1]);
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+
+#include "Node.h"
+
+// Owns all AST nodes of one compilation unit.
+// Nodes are bump allocated in blocks and freed together when the arena is destroyed.
+class NodeArena
+{
+public:
+    NodeArena() = default;
+    ~NodeArena();
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    Node* NewNode(NodeKind kind, Atom value, int lineno);
+
+    // Append a child to the children of the parent. Only valid before the arena is finalized.
+    void AddChild(Node* parent, Node* child);
+
+    // Lay out the children of every node reachable from the root contiguously, in pre-order.
+    // Must be called once the tree is complete and before its children are read.
+    void Finalize(Node* root);
+
+private:
+    static constexpr size_t NODES_PER_BLOCK = 1024;
+
+    std::vector<Node*> blocks;
+    // Number of nodes constructed in the last block.
+    size_t blockUsed = NODES_PER_BLOCK;
+    size_t totalChildren = 0;
+
+    // The child pointers of all nodes. Reserved once, so spans into it stay valid.
+    std::vector<Node*> childStorage;
+};
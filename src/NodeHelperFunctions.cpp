@@ -3,13 +3,13 @@
 #include "NodeHelperFunctions.h"
 #include "CompilerStringDefines.h"
 
-Node* GetNodeChildWithName(const Node* root, std::string name)
+Node* GetNodeChildWithKind(const Node* root, NodeKind kind)
 {
-    if (name != "" && root != nullptr)
+    if (root != nullptr)
     {
         for (Node* child : root->children)
         {
-            if (child->type == name)
+            if (child->kind == kind)
             {
                 return child;
             }
@@ -26,13 +26,8 @@ Node* GetChildAtIndex(const Node* root, int index)
         return nullptr;
     }
 
-    auto it = root->children.begin();
-    for (int i = 0; i < index; i++)
-    {
-        it++;
-    }
-
-    return *it;
+    // Children are stored contiguously, so any child is reached directly.
+    return root->children[index];
 }
 
 Node* GetFirstChild(const Node* root)
@@ -52,25 +47,25 @@ Node* GetRightChild(const Node* binaryRoot)
 
 Node* GetReturnNode(const Node* methodDeclNode)
 {
-    return GetFirstChild(GetNodeChildWithName(methodDeclNode, N_STR_RETURN));
+    return GetFirstChild(GetNodeChildWithKind(methodDeclNode, NodeKind::RETURN));
 }
 
-const std::string* GetMethodExpectedReturnType(const Node* methodDeclNode)
+const Atom* GetMethodExpectedReturnType(const Node* methodDeclNode)
 {
-    if (methodDeclNode != nullptr && methodDeclNode->type == N_STR_METHOD_DECL)
+    if (methodDeclNode != nullptr && methodDeclNode->kind == NodeKind::METHOD_DECL)
         return &methodDeclNode->value;
 
     return nullptr;
 }
 
-const std::string* GetMethodIdentifierName(const Node* methodDeclNode)
+const Atom* GetMethodIdentifierName(const Node* methodDeclNode)
 {
     return &GetMethodIdentifierNode(methodDeclNode)->value;
 }
 
 Node* GetMethodIdentifierNode(const Node* methodDeclNode)
 {
-    if (methodDeclNode != nullptr && methodDeclNode->type == N_STR_METHOD_DECL)
+    if (methodDeclNode != nullptr && methodDeclNode->kind == NodeKind::METHOD_DECL)
     {
         return GetFirstChild(methodDeclNode);
     }
@@ -80,9 +75,9 @@ Node* GetMethodIdentifierNode(const Node* methodDeclNode)
 
 uint32_t GetMethodNumParams(const Node* methodDeclNode)
 {
-    if (methodDeclNode != nullptr && methodDeclNode->type == N_STR_METHOD_DECL)
+    if (methodDeclNode != nullptr && methodDeclNode->kind == NodeKind::METHOD_DECL)
     {
-        Node* paramsNode = GetNodeChildWithName(methodDeclNode, N_STR_PARAMETER_LIST);
+        Node* paramsNode = GetNodeChildWithKind(methodDeclNode, NodeKind::PARAMETER_LIST);
         return paramsNode ? paramsNode->children.size() : 0;
     }
 
@@ -91,18 +86,18 @@ uint32_t GetMethodNumParams(const Node* methodDeclNode)
 
 Node* GetMethodParams(const Node* methodDeclNode)
 {
-    return GetNodeChildWithName(methodDeclNode, N_STR_PARAMETER_LIST);
+    return GetNodeChildWithKind(methodDeclNode, NodeKind::PARAMETER_LIST);
 }
 
 Node* GetClassIdentifierNode(const Node* classDeclNode)
 {
-    if (classDeclNode != nullptr && classDeclNode->type == N_STR_CLASS_DECL)
+    if (classDeclNode != nullptr && classDeclNode->kind == NodeKind::CLASS_DECL)
     {
         return GetFirstChild(classDeclNode);
     }
 }
 
-const std::string* GetClassIdentifierName(const Node* classDeclNode)
+const Atom* GetClassIdentifierName(const Node* classDeclNode)
 {
     if (classDeclNode != nullptr)
     {
@@ -112,7 +107,7 @@ const std::string* GetClassIdentifierName(const Node* classDeclNode)
     return nullptr;
 }
 
-const std::string* GetIdentifierName(const Node* identifierNode)
+const Atom* GetIdentifierName(const Node* identifierNode)
 {
     if (identifierNode != nullptr)
     {
@@ -122,14 +117,14 @@ const std::string* GetIdentifierName(const Node* identifierNode)
     return nullptr;
 }
 
-const std::string* GetIdentifierType(const Node* identifierNode)
+const Atom* GetIdentifierType(const Node* identifierNode)
 {
     return GetIdentifierName(identifierNode);
 }
 
-const std::string* GetVariableName(const Node* variableNode)
+const Atom* GetVariableName(const Node* variableNode)
 {
-    if(variableNode != nullptr && variableNode->type == N_STR_VARIABLE)
+    if(variableNode != nullptr && variableNode->kind == NodeKind::VARIABLE)
     {
         Node* identifierNode = GetFirstChild(variableNode);
         return GetIdentifierName(identifierNode);
@@ -139,13 +134,29 @@ const std::string* GetVariableName(const Node* variableNode)
 
 }
 
+bool IsTypeLiteral(Atom type)
+{
+    return type == Atoms::BOOLEAN || type == Atoms::INT || type == Atoms::STRING || type == Atoms::ARRAY;
+}
+
 bool IsNodeLiteral(const Node* node)
 {
     if (node != nullptr)
     {
-        const std::string& nodeType = node->type == N_STR_VARIABLE ? node->value : node->type;
+        Atom nodeType = node->kind == NodeKind::VARIABLE ? node->value : GetLiteralType(node);
         return IsTypeLiteral(nodeType);
     }
 
     return false;
 }
+
+Atom GetLiteralType(const Node* literalNode)
+{
+    switch (literalNode->kind)
+    {
+        case NodeKind::INT_LITERAL: return Atoms::INT;
+        case NodeKind::BOOLEAN_LITERAL: return Atoms::BOOLEAN;
+        case NodeKind::STRING_LITERAL: return Atoms::STRING;
+        default: return Atoms::EMPTY;
+    }
+}
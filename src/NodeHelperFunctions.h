@@ -3,7 +3,7 @@
 #include <cstdint> // for uint32_t
 #include "Node.h"
 
-Node* GetNodeChildWithName(const Node* root, std::string name);
+Node* GetNodeChildWithKind(const Node* root, NodeKind kind);
 Node* GetChildAtIndex(const Node* root, int index);
 Node* GetFirstChild(const Node* root);
 Node* GetLeftChild(const Node* binaryRoot);
@@ -11,16 +11,20 @@ Node* GetRightChild(const Node* binaryRoot);
 
 Node* GetReturnNode(const Node* methodDeclNode);
 Node* GetClassIdentifierNode(const Node* classDeclNode);
-const std::string* GetClassIdentifierName(const Node* classDeclNode);
+const Atom* GetClassIdentifierName(const Node* classDeclNode);
 
-const std::string* GetMethodExpectedReturnType(const Node* methodDeclNode);
+const Atom* GetMethodExpectedReturnType(const Node* methodDeclNode);
 Node* GetMethodIdentifierNode(const Node* methodDeclNode);
-const std::string* GetMethodIdentifierName(const Node* methodDeclNode);
+const Atom* GetMethodIdentifierName(const Node* methodDeclNode);
 uint32_t GetMethodNumParams(const Node* methodDeclNode);
 Node* GetMethodParams(const Node* methodDeclNode);
 
-const std::string* GetIdentifierName(const Node* identifierNode);
-const std::string* GetIdentifierType(const Node* identifierNode);
-const std::string* GetVariableName(const Node* variableNode);
+const Atom* GetIdentifierName(const Node* identifierNode);
+const Atom* GetIdentifierType(const Node* identifierNode);
+const Atom* GetVariableName(const Node* variableNode);
 
+// Whether the type is one of the builtin types rather than a class.
+bool IsTypeLiteral(Atom type);
 bool IsNodeLiteral(const Node* node);
+// The type of a literal node.
+Atom GetLiteralType(const Node* literalNode);
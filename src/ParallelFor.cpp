@@ -0,0 +1,74 @@
+#include "ParallelFor.h"
+#include "ConsolePrinter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Whether the calling thread is a worker of a ParallelFor.
+static thread_local bool isWorker = false;
+
+void ParallelFor(size_t count, const std::function<void(size_t)>& work, unsigned threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = (unsigned)std::min<size_t>(threadCount, count);
+
+    if (threadCount <= 1 || isWorker)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            work(i);
+        }
+        return;
+    }
+
+    ConsoleStreams callerStreams = GetConsoleStreams();
+
+    std::atomic<size_t> nextIndex(0);
+    std::exception_ptr firstException;
+    std::mutex exceptionMutex;
+
+    // Workers take the next index that has not been started until none are left.
+    auto worker = [&]()
+    {
+        isWorker = true;
+        GetConsoleStreams() = callerStreams;
+
+        for (size_t i = nextIndex++; i < count; i = nextIndex++)
+        {
+            try
+            {
+                work(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!firstException)
+                {
+                    firstException = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threadCount; i++)
+    {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& thread : workers)
+    {
+        thread.join();
+    }
+
+    if (firstException)
+    {
+        std::rethrow_exception(firstException);
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Call work(i) for every i in [0, count) on a pool of worker threads and wait for all calls to finish.
+// Workers print to the console streams of the calling thread. The first exception thrown by a call
+// is rethrown on the calling thread once all workers are done.
+// A threadCount of 0 uses one thread per core. Calls made from inside a worker run serially,
+// so nested loops do not start more threads than there are cores.
+void ParallelFor(size_t count, const std::function<void(size_t)>& work, unsigned threadCount = 0);
@@ -0,0 +1,270 @@
+#include "RegisterContainer.h"
+#include "BytecodeContainer.h"
+#include "BytecodeDefinitions.h"
+#include "CompilerStringDefines.h"
+#include "ConsolePrinter.h"
+
+#include <fstream>
+
+using namespace BytecodeDefinitions;
+
+static const std::unordered_map<Atom, RegisterInstruction> operatorToRegisterOp = {
+    {Atoms::ADD, RegisterInstruction::ADD},
+    {Atoms::SUB, RegisterInstruction::SUB},
+    {Atoms::MUL, RegisterInstruction::MUL},
+    {Atoms::DIV, RegisterInstruction::DIV},
+    {Atoms::NOT, RegisterInstruction::NOT},
+    {Atoms::AND, RegisterInstruction::AND},
+    {Atoms::OR, RegisterInstruction::OR},
+    {Atoms::EQ, RegisterInstruction::EQ},
+    {Atoms::LT, RegisterInstruction::LT},
+    {Atoms::GT, RegisterInstruction::GT}
+};
+
+static const char* RegisterInstructionToString(RegisterInstruction opcode)
+{
+    switch (opcode)
+    {
+        case RegisterInstruction::MOV: return "mov";
+        case RegisterInstruction::ADD: return "add";
+        case RegisterInstruction::SUB: return "sub";
+        case RegisterInstruction::MUL: return "mul";
+        case RegisterInstruction::DIV: return "div";
+        case RegisterInstruction::NOT: return "not";
+        case RegisterInstruction::AND: return "and";
+        case RegisterInstruction::OR: return "or";
+        case RegisterInstruction::EQ: return "eq";
+        case RegisterInstruction::LT: return "lt";
+        case RegisterInstruction::GT: return "gt";
+        case RegisterInstruction::JUMP: return "jump";
+        case RegisterInstruction::JUMPFALSE: return "jumpfalse";
+        case RegisterInstruction::PUSH: return "push";
+        case RegisterInstruction::POP: return "pop";
+        case RegisterInstruction::CALL: return "call";
+        case RegisterInstruction::RETURN: return "return";
+        case RegisterInstruction::PRINT: return "print";
+        case RegisterInstruction::STOP: return "stop";
+        default: return NOT_IMPLEMENTED;
+    }
+}
+
+void RegisterContainer::AddMethod(Atom className, Atom methodName)
+{
+    FinishMethod();
+
+    this->className = className;
+    registers.clear();
+    constantRegisters.clear();
+    objectClasses.clear();
+
+    if (methodName == Atoms::MAIN)
+    {
+        mainMethodId = (int32_t)methods.size();
+    }
+
+    methods.push_back({ AtomToString(className) + DOT + AtomToString(methodName), instructions.size(), 0, {} });
+}
+
+void RegisterContainer::AddBlock(Atom label)
+{
+    labelIndices[label] = instructions.size();
+}
+
+RegisterContainer& RegisterContainer::Add(RegisterInstruction opcode, int32_t a, int32_t b, int32_t c)
+{
+    instructions.push_back({ opcode, a, b, c });
+
+    return *this;
+}
+
+RegisterContainer& RegisterContainer::AddOperator(Atom op, Atom result, Atom arg1, Atom arg2)
+{
+    RegisterInstruction opcode = operatorToRegisterOp.at(op);
+
+    // Unary operators only use the second argument.
+    if (arg1 == Atoms::EMPTY)
+    {
+        return Add(opcode, GetRegister(result), GetRegister(arg2));
+    }
+
+    return Add(opcode, GetRegister(result), GetRegister(arg1), GetRegister(arg2));
+}
+
+RegisterContainer& RegisterContainer::AddJump(Atom label)
+{
+    jumpRelocations.push_back({ instructions.size(), label });
+
+    return Add(RegisterInstruction::JUMP);
+}
+
+RegisterContainer& RegisterContainer::AddCondJump(Atom condition, Atom label)
+{
+    jumpRelocations.push_back({ instructions.size(), label });
+
+    return Add(RegisterInstruction::JUMPFALSE, GetRegister(condition));
+}
+
+void RegisterContainer::AddParam(Atom symbol)
+{
+    pendingParams.push_back(symbol);
+}
+
+RegisterContainer& RegisterContainer::AddCall(Atom result, Atom methodName)
+{
+    Assert(!pendingParams.empty(), "Method call without caller.");
+
+    // The first parameter is the caller, which decides the class of the called method.
+    Atom caller = pendingParams.front();
+    Atom callerClass = caller;
+    if (caller == Atoms::THIS_KEYWORD)
+    {
+        callerClass = className;
+    }
+    else if (objectClasses.count(caller) > 0)
+    {
+        callerClass = objectClasses[caller];
+    }
+
+    // Push the actual arguments.
+    for (size_t i = 1; i < pendingParams.size(); i++)
+    {
+        Add(RegisterInstruction::PUSH, GetRegister(pendingParams[i]));
+    }
+    pendingParams.clear();
+
+    callRelocations.push_back({ instructions.size(), Intern(AtomToString(callerClass) + DOT + AtomToString(methodName)) });
+
+    return Add(RegisterInstruction::CALL, GetRegister(result));
+}
+
+void RegisterContainer::AddObject(Atom symbol, Atom className)
+{
+    objectClasses[symbol] = className;
+}
+
+void RegisterContainer::AddAssign(Atom result, Atom symbol)
+{
+    // Keep track of objects that are assigned to variables.
+    if (objectClasses.count(symbol) > 0)
+    {
+        objectClasses[result] = objectClasses[symbol];
+    }
+
+    Add(RegisterInstruction::MOV, GetRegister(result), GetRegister(symbol));
+}
+
+int32_t RegisterContainer::GetRegister(Atom symbol)
+{
+    const std::string& symbolName = AtomToString(symbol);
+    if (IsLiteral(symbolName))
+    {
+        // Constants are numbered with negative ids until the number of registers of the method is known.
+        auto it = constantRegisters.find(symbol);
+        if (it != constantRegisters.end())
+        {
+            return it->second;
+        }
+
+        std::vector<int>& constants = methods.back().constants;
+        constants.push_back(ParseLiteral(symbolName));
+
+        int32_t constantId = -(int32_t)constants.size();
+        constantRegisters[symbol] = constantId;
+
+        return constantId;
+    }
+
+    auto result = registers.emplace(symbol, (int32_t)registers.size());
+
+    return result.first->second;
+}
+
+void RegisterContainer::FinishMethod()
+{
+    if (methods.empty())
+    {
+        return;
+    }
+
+    RegisterMethod& method = methods.back();
+    method.numRegisters = registers.size();
+
+    // Place the constants right after the other registers of the method.
+    // Jump targets and method ids are never negative before they are resolved, so they are left untouched.
+    for (size_t i = method.entry; i < instructions.size(); i++)
+    {
+        RegisterOp& instruction = instructions[i];
+
+        for (int32_t* operand : { &instruction.a, &instruction.b, &instruction.c })
+        {
+            if (*operand < 0)
+            {
+                *operand = (int32_t)method.numRegisters + (-*operand - 1);
+            }
+        }
+    }
+}
+
+void RegisterContainer::Finalize()
+{
+    FinishMethod();
+
+    for (const Relocation& relocation : jumpRelocations)
+    {
+        auto it = labelIndices.find(relocation.label);
+        Assert(it != labelIndices.end(), "Label not found.");
+
+        RegisterOp& instruction = instructions[relocation.instructionIndex];
+        int32_t& target = instruction.opcode == RegisterInstruction::JUMP ? instruction.a : instruction.b;
+        target = (int32_t)it->second;
+    }
+
+    std::unordered_map<Atom, int32_t> methodIds;
+    for (size_t i = 0; i < methods.size(); i++)
+    {
+        methodIds[Intern(methods[i].label)] = (int32_t)i;
+    }
+
+    // Calls on callers that could not be resolved have no target. These are only reported if they are executed.
+    for (const Relocation& relocation : callRelocations)
+    {
+        auto it = methodIds.find(relocation.label);
+        instructions[relocation.instructionIndex].b = it != methodIds.end() ? it->second : -1;
+    }
+}
+
+bool RegisterContainer::WriteToFile(const std::string& filename)
+{
+    PrintRaw("\nGenerating register code file...\n");
+
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        PrintError("Failed to open register code file for writing.");
+        return false;
+    }
+
+    size_t methodIndex = 0;
+    for (size_t i = 0; i < instructions.size(); i++)
+    {
+        while (methodIndex < methods.size() && methods[methodIndex].entry == i)
+        {
+            const RegisterMethod& method = methods[methodIndex++];
+            file << method.label << COLON << " registers=" << method.numRegisters << " constants=";
+
+            for (int constant : method.constants)
+            {
+                file << constant << DELIMITER;
+            }
+            file << std::endl;
+        }
+
+        const RegisterOp& instruction = instructions[i];
+        file << INDENT << i << COLON << DELIMITER << RegisterInstructionToString(instruction.opcode)
+            << DELIMITER << instruction.a << DELIMITER << instruction.b << DELIMITER << instruction.c << std::endl;
+    }
+
+    PrintRaw("Register code file generated.\n");
+
+    return true;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "Atom.h"
+
+enum class RegisterInstruction
+{
+    MOV,
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    NOT,
+    AND,
+    OR,
+    EQ,
+    LT,
+    GT,
+    JUMP,
+    JUMPFALSE,
+    PUSH,
+    POP,
+    CALL,
+    RETURN,
+    PRINT,
+    STOP,
+    NOT_IMPLEMENTED
+};
+
+// An instruction of the register VM. All register operands are slots in the frame of the current method.
+// Operand a is the destination register of moves and operators, the popped register of pop,
+// the result register of call and the source register of push, return and print.
+// Operands b and c are the source registers of moves and operators.
+// Jump targets are stored in a for jump and in b for jumpfalse, which tests register a.
+// The called method id is stored in b for call.
+struct RegisterOp
+{
+    RegisterInstruction opcode;
+    int32_t a;
+    int32_t b;
+    int32_t c;
+};
+
+struct RegisterMethod
+{
+    std::string label; // The [class].[method] label of the method.
+    size_t entry; // Index of the first instruction of the method.
+    size_t numRegisters; // Number of registers used for parameters, variables and temporaries.
+
+    // The literals used by the method. These are copied into the frame right after the other registers,
+    // which lets every operand be read as a register.
+    std::vector<int> constants;
+};
+
+struct RegisterContainer
+{
+    void AddMethod(Atom className, Atom methodName);
+    void AddBlock(Atom label);
+
+    RegisterContainer& Add(RegisterInstruction opcode, int32_t a = 0, int32_t b = 0, int32_t c = 0);
+    RegisterContainer& AddOperator(Atom op, Atom result, Atom arg1, Atom arg2);
+    RegisterContainer& AddJump(Atom label);
+    RegisterContainer& AddCondJump(Atom condition, Atom label);
+    RegisterContainer& AddCall(Atom result, Atom methodName);
+
+    // Parameters are held back until the call they belong to is added, as the first one is the caller.
+    void AddParam(Atom symbol);
+
+    // Remember the class of a newly created object so calls on it can be bound.
+    void AddObject(Atom symbol, Atom className);
+    void AddAssign(Atom result, Atom symbol);
+
+    // Get the register of a variable, temporary or literal in the current method.
+    int32_t GetRegister(Atom symbol);
+
+    // Resolve all jump targets and call sites. Must be called once every method has been added.
+    void Finalize();
+
+    // Write a readable listing of the register instructions to a file.
+    bool WriteToFile(const std::string& filename);
+
+    std::vector<RegisterOp> instructions;
+    std::vector<RegisterMethod> methods;
+    int32_t mainMethodId = -1;
+
+private:
+    struct Relocation
+    {
+        size_t instructionIndex;
+        Atom label;
+    };
+
+    void FinishMethod();
+
+    // The state of the method that is currently being generated.
+    Atom className = Atoms::EMPTY;
+    std::unordered_map<Atom, int32_t> registers;
+    std::unordered_map<Atom, int32_t> constantRegisters;
+    std::unordered_map<Atom, Atom> objectClasses;
+    std::vector<Atom> pendingParams;
+
+    std::unordered_map<Atom, size_t> labelIndices;
+    std::vector<Relocation> jumpRelocations;
+    std::vector<Relocation> callRelocations;
+};
@@ -0,0 +1,230 @@
+#include "RegisterInterpreter.h"
+#include "BytecodeDefinitions.h"
+#include "ConsolePrinter.h"
+
+#include <algorithm> // std::copy
+
+#if USE_COMPUTED_GOTO
+#define HANDLER(instruction) HANDLER_##instruction:
+#define DISPATCH() \
+    instruction = &code[programCounter++]; \
+    goto *dispatchTable[(size_t)instruction->opcode];
+#else
+#define HANDLER(instruction) case RegisterInstruction::instruction:
+#define DISPATCH() break;
+#endif
+
+#define REGISTER_BINOP(op) \
+    frame[instruction->a] = frame[instruction->b] op frame[instruction->c];
+
+void RegisterInterpreter::Interpret(const RegisterContainer& program)
+{
+    if (program.mainMethodId == -1)
+    {
+        PrintError("No main method found.");
+        return;
+    }
+
+    const std::vector<RegisterOp>& code = program.instructions;
+    const std::vector<RegisterMethod>& methods = program.methods;
+
+    const RegisterMethod& mainMethod = methods[program.mainMethodId];
+    size_t programCounter = mainMethod.entry;
+    size_t framePointer = 0;
+    int* frame = PushFrame(mainMethod);
+    const RegisterOp* instruction = nullptr;
+
+#if USE_COMPUTED_GOTO
+    // Handler addresses in the same order as RegisterInstruction.
+    static void* dispatchTable[] = {
+        &&HANDLER_MOV,
+        &&HANDLER_ADD,
+        &&HANDLER_SUB,
+        &&HANDLER_MUL,
+        &&HANDLER_DIV,
+        &&HANDLER_NOT,
+        &&HANDLER_AND,
+        &&HANDLER_OR,
+        &&HANDLER_EQ,
+        &&HANDLER_LT,
+        &&HANDLER_GT,
+        &&HANDLER_JUMP,
+        &&HANDLER_JUMPFALSE,
+        &&HANDLER_PUSH,
+        &&HANDLER_POP,
+        &&HANDLER_CALL,
+        &&HANDLER_RETURN,
+        &&HANDLER_PRINT,
+        &&HANDLER_STOP,
+        &&HANDLER_NOT_IMPLEMENTED
+    };
+    static_assert(sizeof(dispatchTable) / sizeof(dispatchTable[0]) == (size_t)RegisterInstruction::NOT_IMPLEMENTED + 1,
+        "The dispatch table must have a handler for every instruction.");
+
+    DISPATCH();
+#else
+    while (true)
+    {
+        instruction = &code[programCounter++];
+
+        switch (instruction->opcode)
+        {
+#endif
+            HANDLER(MOV)
+            {
+                frame[instruction->a] = frame[instruction->b];
+                DISPATCH();
+            }
+
+            HANDLER(ADD)
+            {
+                REGISTER_BINOP(+);
+                DISPATCH();
+            }
+
+            HANDLER(SUB)
+            {
+                REGISTER_BINOP(-);
+                DISPATCH();
+            }
+
+            HANDLER(MUL)
+            {
+                REGISTER_BINOP(*);
+                DISPATCH();
+            }
+
+            HANDLER(DIV)
+            {
+                REGISTER_BINOP(/);
+                DISPATCH();
+            }
+
+            HANDLER(NOT)
+            {
+                frame[instruction->a] = !frame[instruction->b];
+                DISPATCH();
+            }
+
+            HANDLER(AND)
+            {
+                REGISTER_BINOP(&&);
+                DISPATCH();
+            }
+
+            HANDLER(OR)
+            {
+                REGISTER_BINOP(||);
+                DISPATCH();
+            }
+
+            HANDLER(EQ)
+            {
+                REGISTER_BINOP(==);
+                DISPATCH();
+            }
+
+            HANDLER(LT)
+            {
+                REGISTER_BINOP(<);
+                DISPATCH();
+            }
+
+            HANDLER(GT)
+            {
+                REGISTER_BINOP(>);
+                DISPATCH();
+            }
+
+            HANDLER(JUMP)
+            {
+                programCounter = (size_t)instruction->a;
+                DISPATCH();
+            }
+
+            HANDLER(JUMPFALSE)
+            {
+                // The true branch is the next instruction.
+                if (frame[instruction->a] == 0)
+                {
+                    programCounter = (size_t)instruction->b;
+                }
+                DISPATCH();
+            }
+
+            HANDLER(PUSH)
+            {
+                arguments.push_back(frame[instruction->a]);
+                DISPATCH();
+            }
+
+            HANDLER(POP)
+            {
+                frame[instruction->a] = arguments.back();
+                arguments.pop_back();
+                DISPATCH();
+            }
+
+            HANDLER(CALL)
+            {
+                int32_t methodId = instruction->b;
+                Assert(methodId != -1, "Method not found.");
+
+                activationStack.push_back({ programCounter, framePointer, instruction->a });
+
+                const RegisterMethod& method = methods[methodId];
+                programCounter = method.entry;
+                framePointer = frames.size();
+                frame = PushFrame(method);
+                DISPATCH();
+            }
+
+            HANDLER(RETURN)
+            {
+                int value = frame[instruction->a];
+
+                // Release the frame of the returning activation.
+                frames.resize(framePointer);
+
+                const RegisterActivation& caller = activationStack.back();
+                programCounter = caller.programCounter;
+                framePointer = caller.framePointer;
+                frame = frames.data() + framePointer;
+                frame[caller.resultRegister] = value;
+                activationStack.pop_back();
+                DISPATCH();
+            }
+
+            HANDLER(PRINT)
+            {
+                PrintRaw("%d\n", frame[instruction->a]);
+                DISPATCH();
+            }
+
+            HANDLER(STOP)
+            {
+                return;
+            }
+
+            HANDLER(NOT_IMPLEMENTED)
+            {
+                Assert(false, "Invalid instruction.");
+                return;
+            }
+#if !USE_COMPUTED_GOTO
+        }
+    }
+#endif
+}
+
+int* RegisterInterpreter::PushFrame(const RegisterMethod& method)
+{
+    // Registers start zeroed, constants are placed right after them.
+    size_t framePointer = frames.size();
+    frames.resize(framePointer + method.numRegisters + method.constants.size(), 0);
+
+    int* frame = frames.data() + framePointer;
+    std::copy(method.constants.begin(), method.constants.end(), frame + method.numRegisters);
+
+    return frame;
+}
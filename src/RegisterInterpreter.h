@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+#include "RegisterContainer.h"
+
+struct RegisterActivation
+{
+    size_t programCounter;
+    size_t framePointer;
+    int32_t resultRegister; // The register of the caller that receives the return value.
+};
+
+class RegisterInterpreter
+{
+public:
+    RegisterInterpreter() = default;
+    ~RegisterInterpreter() = default;
+
+    // Run the main method of the given register program.
+    void Interpret(const RegisterContainer& program);
+
+private:
+    // Allocate a frame for the method on top of the register stack and copy its constants into it.
+    int* PushFrame(const RegisterMethod& method);
+
+    // Arguments pushed by the caller and popped by the called method, in the same order as the stack bytecode.
+    std::vector<int> arguments;
+
+    std::vector<RegisterActivation> activationStack;
+
+    // The frames of all activations. A frame holds the registers of the method followed by its constants.
+    std::vector<int> frames;
+};
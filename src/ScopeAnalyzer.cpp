@@ -5,6 +5,20 @@
 #include "CompilerStringDefines.h"
 #include "CompilerPrinter.h"
 
+// Report an identifier that is declared twice in the same scope.
+static void PrintRedeclaration(const Identifier& identifier, const std::string& scopeString)
+{
+    const Symbol& symbol = identifier.symbol;
+
+    PrintCompErr(
+        "Redeclaration of %s '%s' in scope.\n",
+        identifier.symbolinfo.lineno,
+        scopeString.c_str(),
+        symbol.GetRecord(),
+        symbol.GetName()
+    );
+}
+
 void ScopeAnalyzer::pop()
 {
     if (scopeStack.empty())
@@ -13,32 +27,25 @@ void ScopeAnalyzer::pop()
         return;
     }
 
-    RemoveScopeFromSet(scopeStack.back());
     scopeStack.pop_back();
 }
 
 void ScopeAnalyzer::push(const Scope& scope)
 {
-    scopeStack.push_back(scope);
-    AddScopeToSet(scope);
-}
+    scopeStack.push_back(&scope);
 
-bool ScopeAnalyzer::SymbolExists(const Symbol& symbol)
-{
-    if (symbolLUT.count(symbol) == 0)
+    for (const Identifier* redeclaration : scope.redeclarations)
     {
-        return false;
+        PrintRedeclaration(*redeclaration, BuildScopeString());
     }
-
-    return true;
 }
 
-bool ScopeAnalyzer::ClassExists(const std::string& className)
+bool ScopeAnalyzer::ClassExists(Atom className)
 {
     return GetClass(className) != nullptr;
 }
 
-Identifier* ScopeAnalyzer::GetIdentifier(const std::string& name, SymbolRecord record)
+const Identifier* ScopeAnalyzer::GetIdentifier(Atom name, SymbolRecord record)
 {
     Symbol symbol = Symbol(name, -1, record);
 
@@ -47,96 +54,80 @@ Identifier* ScopeAnalyzer::GetIdentifier(const std::string& name, SymbolRecord r
     {
         symbol.scopeDepth = i; // Set the scope depth to the current scope
 
-        if (SymbolExists(symbol))
+        const Identifier* identifier = scopeStack[i]->FindIdentifier(symbol);
+        if (identifier != nullptr)
         {
-            return &symbolLUT[symbol];
+            return identifier;
         }
     }
 
     return nullptr;
 }
 
-Identifier* ScopeAnalyzer::GetVariable(const std::string& variableName)
+const Identifier* ScopeAnalyzer::GetVariable(Atom variableName)
 {
     return GetIdentifier(variableName, SymbolRecord::VARIABLE);
 }
 
-Identifier* ScopeAnalyzer::GetMethod(const std::string& methodName)
+const Identifier* ScopeAnalyzer::GetMethod(Atom methodName)
 {
     return GetIdentifier(methodName, SymbolRecord::METHOD);
 }
 
-Identifier* ScopeAnalyzer::GetClass(const std::string& className)
+const Identifier* ScopeAnalyzer::GetClass(Atom className)
 {
     return GetIdentifier(className, SymbolRecord::CLASS);
 }
 
-Identifier* ScopeAnalyzer::GetThis()
+const Identifier* ScopeAnalyzer::GetThis()
 {
-    return GetVariable(T_STR_THIS);
+    return GetVariable(Atoms::THIS);
 }
 
-Identifier* ScopeAnalyzer::GetCurrentMethod()
+const Identifier* ScopeAnalyzer::GetCurrentMethod()
 {
-    Scope* scope = GetCurrentScope();
+    const Scope* scope = GetCurrentScope();
 
     if (scope == nullptr)
     {
         return nullptr;
     }
 
-    Identifier* scopeIdentifier = &scope->identifier;
+    const Identifier* scopeIdentifier = &scope->identifier;
 
     // If the last identifier is a method, return it.
     return scopeIdentifier->symbol.record == SymbolRecord::METHOD ? scopeIdentifier : nullptr;
 }
 
-Scope* ScopeAnalyzer::GetCurrentScope()
+const Scope* ScopeAnalyzer::GetCurrentScope()
 {
     if (scopeStack.empty())
     {
         return nullptr;
     }
 
-    return &scopeStack.back();
+    return scopeStack.back();
 }
 
-Identifier* ScopeAnalyzer::GetClassMethod(const std::string& className, const std::string& methodName)
+const Identifier* ScopeAnalyzer::GetClassMethod(Atom className, Atom methodName)
 {
     if (!scopeStack.empty())
     {
-        Scope& globalScope = scopeStack.front();
-        for (const Scope* child : globalScope.children)
-        {
-            if (child->identifier.symbol.name == className)
-            {
-                for (Scope* method : child->children)
-                {
-                    if (method->identifier.symbol.name == methodName)
-                    {
-                        return &method->identifier;
-                    }
-                }
-            }
-        }
+        const Scope* globalScope = scopeStack.front();
+        return globalScope->FindClassMethod(className, methodName);
     }
 
     return nullptr;
 }
 
-bool ScopeAnalyzer::IsInScope(const Identifier& identifier) const
-{
-    return symbolLUT.count(identifier.symbol) > 0;
-}
-
 std::string ScopeAnalyzer::BuildScopeString() const
 {
     std::string scopeString = "";
     // Start from 1 to skip the global scope
     for (int i = 1; i < scopeStack.size(); i++)
     {
-        const SymbolTable* symbolTable = &scopeStack[i];
-        scopeString += symbolTable->identifier.symbol.name;
+        const SymbolTable* symbolTable = scopeStack[i];
+        scopeString += symbolTable->identifier.symbol.GetName();
 
         if (symbolTable->identifier.symbol.record == SymbolRecord::METHOD)
         {
@@ -160,63 +151,5 @@ std::string ScopeAnalyzer::BuildScopeString() const
 
 std::string ScopeAnalyzer::BuildScopedSymbolString(const Identifier& identifier) const
 {
-    return BuildScopeString() + "::" + identifier.symbol.name;
-}
-
-void ScopeAnalyzer::AddIdentifier(const Identifier& identifier)
-{
-    const Symbol& symbol = identifier.symbol;
-
-    if (IsInScope(identifier))
-    {
-        PrintCompErr(
-            "Redeclaration of %s '%s' in scope.\n",
-            identifier.symbolinfo.lineno,
-            BuildScopeString().c_str(),
-            symbol.GetRecord(),
-            symbol.GetName()
-        );
-    }
-
-    // Always update the symbolLUT with the latest identifier to keep it consistent.
-    // Consistency does not guarantee correctness.
-    symbolLUT[symbol] = identifier;
-}
-
-void ScopeAnalyzer::RemoveIdentifier(const Identifier& identifier)
-{
-    symbolLUT.erase(identifier.symbol);
-}
-
-void ScopeAnalyzer::ModifyScopeInSet(const Scope& scope, bool add)
-{
-    static const std::unordered_set<std::string> literalNodeTypes = {
-            T_STR_BOOLEAN,
-            T_STR_INT,
-            T_STR_STRING,
-            T_STR_ARRAY
-    };
-
-    // Modify all variables to the set
-    for (const Identifier& var : scope.variables)
-    {
-        add ? AddIdentifier(var) : RemoveIdentifier(var);
-    }
-
-    // Modify all functions and classes to the set
-    for (const auto& child : scope.children)
-    {
-        const Identifier& symbol = child->identifier;
-        add ? AddIdentifier(symbol) : RemoveIdentifier(symbol);
-    }
-}
-
-void ScopeAnalyzer::AddScopeToSet(const Scope& scope)
-{
-    ModifyScopeInSet(scope, true);
-}
-
-void ScopeAnalyzer::RemoveScopeFromSet(const Scope& scope)
-{
-    ModifyScopeInSet(scope, false);
+    return BuildScopeString() + "::" + identifier.symbol.GetName();
 }
@@ -9,36 +9,29 @@
 
 typedef SymbolTable Scope;
 
+// Tracks the scopes that enclose the code being analyzed. The stack only points to the symbol tables,
+// which are not modified, so several analyzers can walk the same tables at the same time.
 struct ScopeAnalyzer
 {
-    std::vector<Scope> scopeStack;
-    std::unordered_map<Symbol, Identifier> symbolLUT;
+    std::vector<const Scope*> scopeStack;
 
     void pop();
+    // Enter a scope and report the identifiers that are declared twice in it.
     void push(const Scope& scope);
-    Scope* GetCurrentScope();
-    Identifier* GetIdentifier(const std::string& name, SymbolRecord record);
-    Identifier* GetVariable(const std::string& variableName);
-    Identifier* GetMethod(const std::string& methodName);
-    Identifier* GetClass(const std::string& className);
-    Identifier* GetThis();
-    Identifier* GetCurrentMethod();
+    const Scope* GetCurrentScope();
+    const Identifier* GetIdentifier(Atom name, SymbolRecord record);
+    const Identifier* GetVariable(Atom variableName);
+    const Identifier* GetMethod(Atom methodName);
+    const Identifier* GetClass(Atom className);
+    const Identifier* GetThis();
+    const Identifier* GetCurrentMethod();
     
 
-    Identifier* GetClassMethod(const std::string& className, const std::string& methodName);
+    const Identifier* GetClassMethod(Atom className, Atom methodName);
 
-    bool SymbolExists(const Symbol& symbol);
-    bool ClassExists(const std::string& className);
-    const std::string* GetMethodReturnType(const std::string& methodName);
-    bool IsInScope(const Identifier& identifier) const;
+    bool ClassExists(Atom className);
+    const Atom* GetMethodReturnType(Atom methodName);
 
     std::string BuildScopeString() const;
     std::string BuildScopedSymbolString(const Identifier& identifier) const;
-
-private:
-    void AddIdentifier(const Identifier& symbol);
-    void RemoveIdentifier(const Identifier& symbol);
-    void ModifyScopeInSet(const Scope& scope, bool add);
-    void AddScopeToSet(const Scope& scope);
-    void RemoveScopeFromSet(const Scope& scope);
 };
@@ -1,67 +1,109 @@
 #include <unordered_set>
 #include <algorithm> // std::reverse
+#include <array>
 
 #include "SemanticAnalyzer.h"
 #include "ConsolePrinter.h"
 #include "CompilerStringDefines.h"
 #include "NodeHelperFunctions.h"
 #include "CompilerPrinter.h"
+#include "ParallelFor.h"
 
 #define CompilerErr(affectedNode, format, ...) PrintCompErr(format, affectedNode->lineno, scopeAnalyzer.BuildScopeString().c_str(), ##__VA_ARGS__)
 
 // This map is used to store temporary symbols that are used in expressions.
-static std::unordered_map<std::string, SymbolInfo> tempSymbolMap = {
-    { T_STR_BOOLEAN , SymbolInfo(-1, T_STR_BOOLEAN) },
-    { T_STR_INT , SymbolInfo(-1, T_STR_INT) },
-    { T_STR_STRING , SymbolInfo(-1, T_STR_STRING) },
-    { T_STR_VOID , SymbolInfo(-1, T_STR_VOID) },
-    { T_STR_ARRAY , SymbolInfo(-1, T_STR_ARRAY) }
+// It is only read, so the analysis of several programs can share it.
+static const std::unordered_map<Atom, SymbolInfo> tempSymbolMap = {
+    { Atoms::BOOLEAN , SymbolInfo(-1, Atoms::BOOLEAN) },
+    { Atoms::INT , SymbolInfo(-1, Atoms::INT) },
+    { Atoms::STRING , SymbolInfo(-1, Atoms::STRING) },
+    { Atoms::VOID , SymbolInfo(-1, Atoms::VOID) },
+    { Atoms::ARRAY , SymbolInfo(-1, Atoms::ARRAY) }
 };
 
-bool OperationIsBinLogical(const std::string& operation)
+bool OperationIsBinLogical(Atom operation)
 {
-    static unordered_set<std::string> binLogicalOperations = {
-        O_STR_AND,
-        O_STR_OR
+    static unordered_set<Atom> binLogicalOperations = {
+        Atoms::AND,
+        Atoms::OR
     };
 
     return binLogicalOperations.count(operation) > 0;
 }
 
-bool OperationIsBinEquality(const std::string& operation)
+bool OperationIsBinEquality(Atom operation)
 {
-    static unordered_set<std::string> equalityOperations = {
-        O_STR_EQ,
-        O_STR_NE
+    static unordered_set<Atom> equalityOperations = {
+        Atoms::EQ,
+        Atoms::NE
     };
 
     return equalityOperations.count(operation) > 0;
 }
 
-bool OperationIsBinArithmetic(const std::string& operation)
+bool OperationIsBinArithmetic(Atom operation)
 {
-    static unordered_set<std::string> arithmeticOperations = {
-        O_STR_ADD,
-        O_STR_SUB,
-        O_STR_MUL,
-        O_STR_DIV
+    static unordered_set<Atom> arithmeticOperations = {
+        Atoms::ADD,
+        Atoms::SUB,
+        Atoms::MUL,
+        Atoms::DIV
     };
 
     return arithmeticOperations.count(operation) > 0;
 }
 
-bool OperationIsBinArithmeticComparison(const std::string& operation)
+bool OperationIsBinArithmeticComparison(Atom operation)
 {
-    static unordered_set<std::string> arithmeticComparisonOperations = {
-        O_STR_LT,
-        O_STR_GT,
-        O_STR_LEQ,
-        O_STR_GEQ
+    static unordered_set<Atom> arithmeticComparisonOperations = {
+        Atoms::LT,
+        Atoms::GT,
+        Atoms::LEQ,
+        Atoms::GEQ
     };
 
     return arithmeticComparisonOperations.count(operation) > 0;
 }
 
+bool AnalyzeProgram(const Node* astRoot, const SymbolTable* symbolTableRoot)
+{
+    Assert(astRoot != nullptr, "Cannot analyze semantics of null node.\n");
+
+    // Cannot properly parse the AST if the symbol table is null.
+    if (symbolTableRoot == nullptr)
+    {
+        return false;
+    }
+
+    // Entering the global scope reports its redeclarations once, before the classes are analyzed.
+    ScopeAnalyzer globalScopeAnalyzer;
+    globalScopeAnalyzer.push(*symbolTableRoot);
+
+    // Analyze each class with its own scope analyzer, capturing its diagnostics to print them in source order afterwards.
+    const std::vector<SymbolTable*>& classTables = symbolTableRoot->children;
+    std::vector<char> classResults(classTables.size(), true);
+    std::vector<CapturedOutput> classDiagnostics(classTables.size());
+
+    ParallelFor(classTables.size(), [&](size_t i)
+        {
+            ConsoleCapture capture(classDiagnostics[i]);
+            // Symbol tables are only read, so every class can start from a copy of the global scope stack.
+            ScopeAnalyzer scopeAnalyzer = globalScopeAnalyzer;
+
+            classResults[i] = AnalyzeStructure(classTables[i]->astNode, classTables[i], scopeAnalyzer);
+        });
+
+    // Assume that the structure is valid until proven otherwise.
+    bool validStructure = true;
+    for (size_t i = 0; i < classTables.size(); i++)
+    {
+        classDiagnostics[i].Print();
+        validStructure = validStructure && classResults[i];
+    }
+
+    return validStructure;
+}
+
 bool AnalyzeStructure(const Node* astRoot, const SymbolTable* symbolTableRoot, ScopeAnalyzer& scopeAnalyzer)
 {
     Assert(astRoot != nullptr, "Cannot analyze semantics of null node.\n");
@@ -78,19 +120,10 @@ bool AnalyzeStructure(const Node* astRoot, const SymbolTable* symbolTableRoot, S
     // Assume that the structure is valid until proven otherwise.
     bool validStructure = true;
 
-    // Loop through all class declarations and analyze them
-    if (astRoot->type == N_STR_PROGRAM)
-    {
-        for (auto child : symbolTableRoot->children)
-        {
-            bool result = AnalyzeStructure(child->astNode, child, scopeAnalyzer);
-            validStructure = validStructure && result;
-        }
-    }
     // Loop through all method declarations and analyze them
-    else if (astRoot->type == N_STR_CLASS_DECL || astRoot->type == N_STR_MAIN_CLASS)
+    if (astRoot->kind == NodeKind::CLASS_DECL || astRoot->kind == NodeKind::MAIN_CLASS)
     {
-        Node* variableDeclarations = GetNodeChildWithName(astRoot, N_STR_VARIABLE_DECLS);
+        Node* variableDeclarations = GetNodeChildWithKind(astRoot, NodeKind::VARIABLE_DECLS);
         if (variableDeclarations != nullptr)
         {
             // Analyze the variable declarations
@@ -107,7 +140,7 @@ bool AnalyzeStructure(const Node* astRoot, const SymbolTable* symbolTableRoot, S
             validStructure = validStructure && result;
         }
     }
-    else if (astRoot->type == N_STR_METHOD_DECL)
+    else if (astRoot->kind == NodeKind::METHOD_DECL)
     {
         const Identifier* methodIdentifier = scopeAnalyzer.GetCurrentMethod();
 
@@ -117,12 +150,12 @@ bool AnalyzeStructure(const Node* astRoot, const SymbolTable* symbolTableRoot, S
         if (methodIdentifier != nullptr)
         {
             // Analyze the method body
-            Node* methodBodyNode = GetNodeChildWithName(astRoot, N_STR_METHOD_BODY);
+            Node* methodBodyNode = GetNodeChildWithKind(astRoot, NodeKind::METHOD_BODY);
             bool result = AnalyzeStatement(methodBodyNode, scopeAnalyzer);
             validStructure = validStructure && result;
 
             // Analyze the return statement if the method is not main (main does not have a return statement).
-            if (methodIdentifier->symbol.name != "main")
+            if (methodIdentifier->symbol.name != Atoms::MAIN)
             {
                 const IdentifierDatatype& expectedReturnType = methodIdentifier->symbolinfo.type;
                 const Node* returnNode = GetReturnNode(astRoot);
@@ -136,8 +169,8 @@ bool AnalyzeStructure(const Node* astRoot, const SymbolTable* symbolTableRoot, S
                             returnNode,
                             "Method '%s' has incorrect return type (expected '%s', got '%s').\n",
                             methodIdentifier->symbol.GetName(),
-                            expectedReturnType.c_str(),
-                            returnInfo->type.c_str()
+                            AtomCStr(expectedReturnType),
+                            AtomCStr(returnInfo->type)
                         );
 
                         validStructure = false;
@@ -156,399 +189,493 @@ bool AnalyzeStructure(const Node* astRoot, const SymbolTable* symbolTableRoot, S
     return validStructure;
 }
 
-// Returns whether the statement is valid or not.
-bool AnalyzeStatement(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+// Statement lists and method bodies.
+static bool AnalyzeStatements(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
 {
-    if (astRoot == nullptr)
+    bool results = true;
+    // Loop through all statements and analyze them.
+    for (auto statementNode : astRoot->children)
     {
-        // If the statement is null, then regard it as valid.
-        return true;
-    }
-    else if (
-        astRoot->type == N_STR_STATEMENTS ||
-        astRoot->type == N_STR_METHOD_BODY
-        )
-    {
-        bool results = true;
-        // Loop through all statements and analyze them.
-        for (auto statementNode : astRoot->children)
+        if (statementNode != nullptr)
         {
-            if (statementNode != nullptr)
-            {
-                bool result = AnalyzeStatement(statementNode, scopeAnalyzer);
-                results = results && result;
-            }
+            bool result = AnalyzeStatement(statementNode, scopeAnalyzer);
+            results = results && result;
         }
+    }
+
+    return results;
+}
 
-        return results;
+// A variable declaration is a statement.
+static bool AnalyzeVariableDeclaration(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    if (IsNodeLiteral(astRoot))
+    {
+        // If the variable is a literal, then it is a valid declaration.
+        return true;
     }
-    else if (astRoot->type == N_STR_VARIABLE)
+
+    const Identifier* classIdentifier = GetClass(astRoot, scopeAnalyzer);
+    if (classIdentifier == nullptr)
     {
-        // A variable declaration is a statement.
-        if (IsNodeLiteral(astRoot))
+        return false;
+    }
+
+    return true;
+}
+
+static bool AnalyzeIfStatement(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    Node* conditionNode = GetLeftChild(astRoot);
+    const SymbolInfo* conditionInfo = AnalyzeExpression(conditionNode, scopeAnalyzer);
+
+    if (conditionInfo != nullptr)
+    {
+        if (conditionInfo->type != Atoms::BOOLEAN)
         {
-            // If the variable is a literal, then it is a valid declaration.
-            return true;
+            CompilerErr(conditionNode, "If condition must be of type 'boolean' (got '%s').\n", AtomCStr(conditionInfo->type));
+            return false;
         }
 
-        const Identifier* classIdentifier = GetClass(astRoot, scopeAnalyzer);
-        if (classIdentifier == nullptr)
+        // Loop through the rest of the branches which will be the body of 
+        // the if statement and possibly the else statement, if it exists.
+        for (int i = 1; i < astRoot->children.size(); i++)
         {
-            return false;
+            Node* branchNode = GetChildAtIndex(astRoot, i);
+            if (branchNode != nullptr)
+                AnalyzeStatement(branchNode, scopeAnalyzer);
         }
     }
-    else if (astRoot->value == N_STR_CONDITIONAL_BRANCH)
-    {
-        Node* conditionNode = GetLeftChild(astRoot);
-        const SymbolInfo* conditionInfo = AnalyzeExpression(conditionNode, scopeAnalyzer);
 
-        if (conditionInfo != nullptr)
+    return true;
+}
+
+static bool AnalyzeAssignment(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    // Assumes that assignment is of the form "lhs = rhs" (which is the only form of assignment in this language).
+    Node* lhsNode = GetLeftChild(astRoot);
+    Node* rhsNode = GetRightChild(astRoot);
+
+    // Get lhs symbol info.
+    const Identifier* lhsIdentifier = GetVariable(lhsNode, scopeAnalyzer);
+    if (lhsIdentifier != nullptr)
+    {
+        const SymbolInfo* lhsInfo = &lhsIdentifier->symbolinfo;
+        const SymbolInfo* rhsInfo = AnalyzeExpression(rhsNode, scopeAnalyzer);
+        Assert(lhsInfo != nullptr, "Lhs info is null.\n");
+        if (rhsInfo != nullptr)
         {
-            if (conditionInfo->type != T_STR_BOOLEAN)
+            // Handle the assignment.
+            if (!IsSameType(*lhsInfo, *rhsInfo))
             {
-                CompilerErr(conditionNode, "If condition must be of type 'boolean' (got '%s').\n", conditionInfo->type.c_str());
+                CompilerErr(astRoot, "Cannot assign rhs value of type '%s' to lhs variable of type '%s'.\n", AtomCStr(rhsInfo->type), AtomCStr(lhsInfo->type));
                 return false;
             }
-
-            // Loop through the rest of the branches which will be the body of 
-            // the if statement and possibly the else statement, if it exists.
-            for (int i = 1; i < astRoot->children.size(); i++)
-            {
-                Node* branchNode = GetChildAtIndex(astRoot, i);
-                if (branchNode != nullptr)
-                    AnalyzeStatement(branchNode, scopeAnalyzer);
-            }
         }
     }
-    else if (astRoot->value == N_STR_ASSIGNMENT)
-    {
-        // Assumes that assignment is of the form "lhs = rhs" (which is the only form of assignment in this language).
-        Node* lhsNode = GetLeftChild(astRoot);
-        Node* rhsNode = GetRightChild(astRoot);
 
-        // Get lhs symbol info.
-        const Identifier* lhsIdentifier = GetVariable(lhsNode, scopeAnalyzer);
-        if (lhsIdentifier != nullptr)
-        {
-            const SymbolInfo* lhsInfo = &lhsIdentifier->symbolinfo;
-            const SymbolInfo* rhsInfo = AnalyzeExpression(rhsNode, scopeAnalyzer);
-            Assert(lhsInfo != nullptr, "Lhs info is null.\n");
-            if (rhsInfo != nullptr)
-            {
-                // Handle the assignment.
-                if (!IsSameType(*lhsInfo, *rhsInfo))
-                {
-                    CompilerErr(astRoot, "Cannot assign rhs value of type '%s' to lhs variable of type '%s'.\n", rhsInfo->type.c_str(), lhsInfo->type.c_str());
-                    return false;
-                }
-            }
-        }
+    return true;
+}
+
+static bool AnalyzeWhileLoop(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    Node* conditionNode = GetLeftChild(astRoot);
+    const SymbolInfo* conditionInfo = AnalyzeExpression(conditionNode, scopeAnalyzer);
+    if (conditionInfo == nullptr)
+    {
+        CompilerErr(conditionNode, "While condition is faulty.\n");
+        return false;
     }
-    else if (astRoot->value == N_STR_WHILE)
+    else
     {
-        Node* conditionNode = GetLeftChild(astRoot);
-        const SymbolInfo* conditionInfo = AnalyzeExpression(conditionNode, scopeAnalyzer);
-        if (conditionInfo == nullptr)
+        if (conditionInfo->type != Atoms::BOOLEAN)
         {
-            CompilerErr(conditionNode, "While condition is faulty.\n");
+            CompilerErr(conditionNode, "While condition must be of type 'boolean' (got '%s').\n", AtomCStr(conditionInfo->type));
             return false;
         }
-        else
-        {
-            if (conditionInfo->type != T_STR_BOOLEAN)
-            {
-                CompilerErr(conditionNode, "While condition must be of type 'boolean' (got '%s').\n", conditionInfo->type.c_str());
-                return false;
-            }
-        }
-
-        // Analyze the body of the while loop.
-        Node* bodyNode = GetRightChild(astRoot);
-        AnalyzeStatement(bodyNode, scopeAnalyzer);
     }
-    else if (astRoot->value == N_STR_INDEX_ASSIGNMENT)
-    {
-        Node* arrNode = GetFirstChild(astRoot);
-        Node* indexNode = GetChildAtIndex(astRoot, 1);
-        Node* rhsNode = GetChildAtIndex(astRoot, 2);
 
-        const SymbolInfo* arrInfo = AnalyzeExpression(arrNode, scopeAnalyzer);
-        const SymbolInfo* indexInfo = AnalyzeExpression(indexNode, scopeAnalyzer);
-        const SymbolInfo* rhsInfo = AnalyzeExpression(rhsNode, scopeAnalyzer);
+    // Analyze the body of the while loop.
+    Node* bodyNode = GetRightChild(astRoot);
+    AnalyzeStatement(bodyNode, scopeAnalyzer);
+
+    return true;
+}
+
+static bool AnalyzeIndexAssignment(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    Node* arrNode = GetFirstChild(astRoot);
+    Node* indexNode = GetChildAtIndex(astRoot, 1);
+    Node* rhsNode = GetChildAtIndex(astRoot, 2);
+
+    const SymbolInfo* arrInfo = AnalyzeExpression(arrNode, scopeAnalyzer);
+    const SymbolInfo* indexInfo = AnalyzeExpression(indexNode, scopeAnalyzer);
+    const SymbolInfo* rhsInfo = AnalyzeExpression(rhsNode, scopeAnalyzer);
 
-        if (arrInfo != nullptr && indexInfo != nullptr && rhsInfo != nullptr)
+    if (arrInfo != nullptr && indexInfo != nullptr && rhsInfo != nullptr)
+    {
+        if (arrInfo->type != Atoms::ARRAY)
         {
-            if (arrInfo->type != T_STR_ARRAY)
-            {
-                CompilerErr(indexNode, "Cannot index non-array type '%s'.\n", arrInfo->type.c_str());
-            }
-            else if (indexInfo->type != T_STR_INT)
-            {
-                CompilerErr(indexNode, "Cannot index array with non-integer type '%s'.\n", indexInfo->type.c_str());
-            }
-            else if (rhsInfo->type != T_STR_INT)
-            {
-                CompilerErr(rhsNode, "Cannot assign non-integer type '%s' to array.\n", rhsInfo->type.c_str());
-            }
+            CompilerErr(indexNode, "Cannot index non-array type '%s'.\n", AtomCStr(arrInfo->type));
+        }
+        else if (indexInfo->type != Atoms::INT)
+        {
+            CompilerErr(indexNode, "Cannot index array with non-integer type '%s'.\n", AtomCStr(indexInfo->type));
+        }
+        else if (rhsInfo->type != Atoms::INT)
+        {
+            CompilerErr(rhsNode, "Cannot assign non-integer type '%s' to array.\n", AtomCStr(rhsInfo->type));
         }
     }
-    else if (astRoot->value == N_STR_SYSTEM_PRINT)
-    {
-        Node* printNode = GetFirstChild(astRoot);
 
-        const SymbolInfo* printInfo = AnalyzeExpression(printNode, scopeAnalyzer);
-        Assert(printInfo != nullptr, "Print info is null.\n");
+    return true;
+}
 
-        // Because the print statement can print anything, it is always valid if the print info is not null.
-    }
+static bool AnalyzeSystemPrint(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    Node* printNode = GetFirstChild(astRoot);
+
+    const SymbolInfo* printInfo = AnalyzeExpression(printNode, scopeAnalyzer);
+    Assert(printInfo != nullptr, "Print info is null.\n");
+
+    // Because the print statement can print anything, it is always valid if the print info is not null.
 
     return true;
 }
 
-// An expression always resolves to a type which is returned by this function.
-// An expression can be faulty, in which case it returns nullptr.
-const SymbolInfo* AnalyzeExpression(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+typedef bool (*StatementAnalyzer)(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer);
+
+// The analyzer of each statement kind, indexed by node kind. Other kinds are regarded as valid statements.
+static const std::array<StatementAnalyzer, (size_t)NodeKind::COUNT> statementAnalyzers = []
+    {
+        std::array<StatementAnalyzer, (size_t)NodeKind::COUNT> analyzers = {};
+        analyzers[(size_t)NodeKind::STATEMENTS] = AnalyzeStatements;
+        analyzers[(size_t)NodeKind::METHOD_BODY] = AnalyzeStatements;
+        analyzers[(size_t)NodeKind::VARIABLE] = AnalyzeVariableDeclaration;
+        analyzers[(size_t)NodeKind::CONDITIONAL_BRANCH] = AnalyzeIfStatement;
+        analyzers[(size_t)NodeKind::ASSIGNMENT] = AnalyzeAssignment;
+        analyzers[(size_t)NodeKind::WHILE] = AnalyzeWhileLoop;
+        analyzers[(size_t)NodeKind::INDEX_ASSIGNMENT] = AnalyzeIndexAssignment;
+        analyzers[(size_t)NodeKind::SYSTEM_PRINT] = AnalyzeSystemPrint;
+        return analyzers;
+    }();
+
+// Returns whether the statement is valid or not.
+bool AnalyzeStatement(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    if (astRoot == nullptr)
+    {
+        // If the statement is null, then regard it as valid.
+        return true;
+    }
+
+    StatementAnalyzer analyzer = statementAnalyzers[(size_t)astRoot->kind];
+
+    return analyzer != nullptr ? analyzer(astRoot, scopeAnalyzer) : true;
+}
+
+static const SymbolInfo* AnalyzeIdentifier(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
 {
     const SymbolInfo* returnedType = nullptr;
 
-    if (astRoot->type == N_STR_IDENTIFIER)
+    const Identifier* identifier = GetVariable(astRoot, scopeAnalyzer);
+    if (identifier != nullptr)
     {
-        const Identifier* identifier = GetVariable(astRoot, scopeAnalyzer);
-        if (identifier != nullptr)
+        if (astRoot->lineno < identifier->symbolinfo.lineno)
         {
-            if (astRoot->lineno < identifier->symbolinfo.lineno)
-            {
-                CompilerErr(astRoot, "Variable '%s' is used before it is declared.\n", identifier->symbol.GetName());
-            }
-            else
-            {
-                returnedType = &identifier->symbolinfo;
-            }
+            CompilerErr(astRoot, "Variable '%s' is used before it is declared.\n", identifier->symbol.GetName());
+        }
+        else
+        {
+            returnedType = &identifier->symbolinfo;
         }
     }
-    else if (astRoot->value == N_STR_METHOD_CALL)
-    {
-        const SymbolInfo* callerInfo = AnalyzeExpression(GetFirstChild(astRoot), scopeAnalyzer);
-        Assert(callerInfo != nullptr, "Caller info is null.\n");
-        const std::string& className = callerInfo->type;
 
-        const Node* methodCallNode = GetChildAtIndex(astRoot, 1);
-        Assert(methodCallNode != nullptr, "Method call node is null.\n");
-        const std::string* methodName = GetIdentifierName(methodCallNode);
-        Assert(methodName != nullptr, "Method name is null.\n");
+    return returnedType;
+}
+
+static const SymbolInfo* AnalyzeMethodCall(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    const SymbolInfo* returnedType = nullptr;
+
+    const SymbolInfo* callerInfo = AnalyzeExpression(GetFirstChild(astRoot), scopeAnalyzer);
+    Assert(callerInfo != nullptr, "Caller info is null.\n");
+    IdentifierDatatype className = callerInfo->type;
+
+    const Node* methodCallNode = GetChildAtIndex(astRoot, 1);
+    Assert(methodCallNode != nullptr, "Method call node is null.\n");
+    const Atom* methodName = GetIdentifierName(methodCallNode);
+    Assert(methodName != nullptr, "Method name is null.\n");
+
+    if (scopeAnalyzer.ClassExists(callerInfo->type))
+    {
+        IdentifierDatatype className = callerInfo->type;
+        const Identifier* methodIdentifier = scopeAnalyzer.GetClassMethod(className, *methodName);
 
-        if (scopeAnalyzer.ClassExists(callerInfo->type))
+        if (methodIdentifier != nullptr)
         {
-            const std::string& className = callerInfo->type;
-            const Identifier* methodIdentifier = scopeAnalyzer.GetClassMethod(className, *methodName);
+            const Node* methodArguments = GetNodeChildWithKind(astRoot, NodeKind::ARGUMENT_LIST);
 
-            if (methodIdentifier != nullptr)
+            std::vector<IdentifierDatatype> argumentTypes;
+            if (methodArguments != nullptr)
             {
-                const Node* methodArguments = GetNodeChildWithName(astRoot, N_STR_ARGUMENT_LIST);
-
-                std::vector<IdentifierDatatype> argumentTypes;
-                if (methodArguments != nullptr)
+                for (auto argument : methodArguments->children)
                 {
-                    for (auto argument : methodArguments->children)
+                    const SymbolInfo* argumentInfo = AnalyzeExpression(argument, scopeAnalyzer);
+                    if (argumentInfo != nullptr)
                     {
-                        const SymbolInfo* argumentInfo = AnalyzeExpression(argument, scopeAnalyzer);
-                        if (argumentInfo != nullptr)
-                        {
-                            argumentTypes.push_back(argumentInfo->type);
-                        }
+                        argumentTypes.push_back(argumentInfo->type);
                     }
                 }
+            }
 
-                uint32_t methodExpectedParams = methodIdentifier->symbolinfo.typeParameters.size();
-                uint32_t methodActualParams = argumentTypes.size();
+            uint32_t methodExpectedParams = methodIdentifier->symbolinfo.typeParameters.size();
+            uint32_t methodActualParams = argumentTypes.size();
 
-                if (methodExpectedParams != methodActualParams)
-                {
-                    CompilerErr(methodCallNode, "Method '%s' expects %d parameters, but %d were given.\n", methodName->c_str(), methodExpectedParams, methodActualParams);
-                }
-                else
+            if (methodExpectedParams != methodActualParams)
+            {
+                CompilerErr(methodCallNode, "Method '%s' expects %d parameters, but %d were given.\n", AtomCStr(*methodName), methodExpectedParams, methodActualParams);
+            }
+            else
+            {
+                for (uint32_t i = 0; i < methodExpectedParams; i++)
                 {
-                    for (uint32_t i = 0; i < methodExpectedParams; i++)
+                    if (methodIdentifier->symbolinfo.typeParameters[i] != argumentTypes[i])
                     {
-                        if (methodIdentifier->symbolinfo.typeParameters[i] != argumentTypes[i])
-                        {
-                            CompilerErr(methodCallNode, "Method '%s' expects parameter %d to be of type '%s', but got type '%s'.\n", methodName->c_str(), i, methodIdentifier->symbolinfo.typeParameters[i].c_str(), argumentTypes[i].c_str());
-                        }
+                        CompilerErr(methodCallNode, "Method '%s' expects parameter %d to be of type '%s', but got type '%s'.\n", AtomCStr(*methodName), i, AtomCStr(methodIdentifier->symbolinfo.typeParameters[i]), AtomCStr(argumentTypes[i]));
                     }
                 }
-
-                // Even if other compiler errors are found, we still return the type of the method for type checking.
-                returnedType = &methodIdentifier->symbolinfo;
-            }
-            else
-            {
-                CompilerErr(methodCallNode, "Method '%s' does not exist in class '%s'.\n", methodName->c_str(), callerInfo->type.c_str());
             }
+
+            // Even if other compiler errors are found, we still return the type of the method for type checking.
+            returnedType = &methodIdentifier->symbolinfo;
         }
         else
         {
-            CompilerErr(astRoot, "Invalid member access on returned type '%s'.\n", callerInfo->type.c_str());
+            CompilerErr(methodCallNode, "Method '%s' does not exist in class '%s'.\n", AtomCStr(*methodName), AtomCStr(callerInfo->type));
         }
     }
-    else if (astRoot->type == N_STR_BINARY_OPERATION)
+    else
     {
-        const SymbolInfo* leftSymbol = AnalyzeExpression(GetLeftChild(astRoot), scopeAnalyzer);
-        const SymbolInfo* rightSymbol = AnalyzeExpression(GetRightChild(astRoot), scopeAnalyzer);
+        CompilerErr(astRoot, "Invalid member access on returned type '%s'.\n", AtomCStr(callerInfo->type));
+    }
 
-        if (leftSymbol != nullptr && rightSymbol != nullptr)
-        {
-            const std::string& operation = astRoot->value;
+    return returnedType;
+}
 
-            // If the operation is a comparison, then the types of the left and right operands must be the same.
-            // The type must be either int or boolean.
-            if (leftSymbol->type == rightSymbol->type)
+static const SymbolInfo* AnalyzeBinaryOperation(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    const SymbolInfo* returnedType = nullptr;
+
+    const SymbolInfo* leftSymbol = AnalyzeExpression(GetLeftChild(astRoot), scopeAnalyzer);
+    const SymbolInfo* rightSymbol = AnalyzeExpression(GetRightChild(astRoot), scopeAnalyzer);
+
+    if (leftSymbol != nullptr && rightSymbol != nullptr)
+    {
+        Atom operation = astRoot->value;
+
+        // If the operation is a comparison, then the types of the left and right operands must be the same.
+        // The type must be either int or boolean.
+        if (leftSymbol->type == rightSymbol->type)
+        {
+            if (OperationIsBinLogical(operation))
             {
-                if (OperationIsBinLogical(operation))
+                if (leftSymbol->type != Atoms::BOOLEAN)
                 {
-                    if (leftSymbol->type != T_STR_BOOLEAN)
-                    {
-                        CompilerErr(astRoot, "Cannot perform binary logical operation '%s' on type '%s'.\n", operation.c_str(), leftSymbol->type.c_str());
-                    }
-                    else
-                    {
-                        returnedType = &tempSymbolMap[T_STR_BOOLEAN];
-                    }
+                    CompilerErr(astRoot, "Cannot perform binary logical operation '%s' on type '%s'.\n", AtomCStr(operation), AtomCStr(leftSymbol->type));
                 }
-                else if (OperationIsBinArithmetic(operation))
+                else
                 {
-                    if (leftSymbol->type != T_STR_INT)
-                    {
-                        CompilerErr(astRoot, "Cannot perform binary arithmetic operation '%s' on type '%s'.\n", operation.c_str(), leftSymbol->type.c_str());
-                    }
-                    else
-                    {
-                        // The type of the result is the same as the type of the operands (int).
-                        returnedType = leftSymbol;
-                    }
+                    returnedType = &tempSymbolMap.at(Atoms::BOOLEAN);
                 }
-                else if (OperationIsBinArithmeticComparison(operation))
+            }
+            else if (OperationIsBinArithmetic(operation))
+            {
+                if (leftSymbol->type != Atoms::INT)
                 {
-                    if (leftSymbol->type != T_STR_INT)
-                    {
-                        CompilerErr(astRoot, "Cannot perform binary arithmetic comparison operation '%s' on type '%s'.\n", operation.c_str(), leftSymbol->type.c_str());
-                    }
-                    else
-                    {
-                        returnedType = &tempSymbolMap[T_STR_BOOLEAN];
-                    }
+                    CompilerErr(astRoot, "Cannot perform binary arithmetic operation '%s' on type '%s'.\n", AtomCStr(operation), AtomCStr(leftSymbol->type));
                 }
-                else if (OperationIsBinEquality(operation))
+                else
                 {
-                    if (leftSymbol->type != T_STR_INT && leftSymbol->type != T_STR_BOOLEAN)
-                    {
-                        CompilerErr(astRoot, "Cannot perform binary equality operation '%s' on type '%s'.\n", operation.c_str(), leftSymbol->type.c_str());
-                    }
-                    else
-                    {
-                        returnedType = &tempSymbolMap[T_STR_BOOLEAN];
-                    }
+                    // The type of the result is the same as the type of the operands (int).
+                    returnedType = leftSymbol;
                 }
             }
-            else
+            else if (OperationIsBinArithmeticComparison(operation))
             {
-                CompilerErr(astRoot, "Cannot perform binary operation '%s' on symbols of different types: '%s' and '%s'.\n", operation.c_str(), leftSymbol->type.c_str(), rightSymbol->type.c_str());
-            }
-        }
-    }
-    else if (astRoot->type == N_STR_UNARY_OPERATION)
-    {
-        const SymbolInfo* operandSymbol = AnalyzeExpression(GetFirstChild(astRoot), scopeAnalyzer);
-        if (operandSymbol != nullptr && astRoot->value == O_STR_NOT)
-        {
-            if (operandSymbol->type != T_STR_BOOLEAN)
-            {
-                CompilerErr(astRoot, "Cannot perform negation operation on type '%s'.\n", operandSymbol->type.c_str());
+                if (leftSymbol->type != Atoms::INT)
+                {
+                    CompilerErr(astRoot, "Cannot perform binary arithmetic comparison operation '%s' on type '%s'.\n", AtomCStr(operation), AtomCStr(leftSymbol->type));
+                }
+                else
+                {
+                    returnedType = &tempSymbolMap.at(Atoms::BOOLEAN);
+                }
             }
-            else
+            else if (OperationIsBinEquality(operation))
             {
-                returnedType = operandSymbol;
+                if (leftSymbol->type != Atoms::INT && leftSymbol->type != Atoms::BOOLEAN)
+                {
+                    CompilerErr(astRoot, "Cannot perform binary equality operation '%s' on type '%s'.\n", AtomCStr(operation), AtomCStr(leftSymbol->type));
+                }
+                else
+                {
+                    returnedType = &tempSymbolMap.at(Atoms::BOOLEAN);
+                }
             }
         }
-    }
-    else if (astRoot->value == N_STR_CLOSED_EXPR)
-    {
-        returnedType = AnalyzeExpression(GetFirstChild(astRoot), scopeAnalyzer);
-    }
-    else if (astRoot->value == N_STR_NEW)
-    {
-        Node* identifierNode = GetFirstChild(astRoot);
-        const Identifier* classIdentifier = GetClass(identifierNode, scopeAnalyzer);
-        if (classIdentifier != nullptr)
+        else
         {
-            returnedType = &classIdentifier->symbolinfo;
+            CompilerErr(astRoot, "Cannot perform binary operation '%s' on symbols of different types: '%s' and '%s'.\n", AtomCStr(operation), AtomCStr(leftSymbol->type), AtomCStr(rightSymbol->type));
         }
     }
-    else if (astRoot->value == N_STR_NEW_ARR)
+
+    return returnedType;
+}
+
+static const SymbolInfo* AnalyzeUnaryOperation(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    const SymbolInfo* returnedType = nullptr;
+
+    const SymbolInfo* operandSymbol = AnalyzeExpression(GetFirstChild(astRoot), scopeAnalyzer);
+    if (operandSymbol != nullptr && astRoot->value == Atoms::NOT)
     {
-        const SymbolInfo* sizeInfo = AnalyzeExpression(GetFirstChild(astRoot), scopeAnalyzer);
-        if (sizeInfo != nullptr)
+        if (operandSymbol->type != Atoms::BOOLEAN)
         {
-            if (sizeInfo->type != T_STR_INT)
-            {
-                CompilerErr(astRoot, "Cannot create array of size using type '%s'. Size must be of type 'int'.\n", sizeInfo->type.c_str());
-            }
-            else
-            {
-                returnedType = &tempSymbolMap[T_STR_ARRAY];
-            }
+            CompilerErr(astRoot, "Cannot perform negation operation on type '%s'.\n", AtomCStr(operandSymbol->type));
+        }
+        else
+        {
+            returnedType = operandSymbol;
         }
     }
-    else if (IsNodeLiteral(astRoot))
-    {
-        returnedType = &tempSymbolMap[astRoot->type];
-    }
-    else if (astRoot->type == T_STR_THIS)
+
+    return returnedType;
+}
+
+static const SymbolInfo* AnalyzeNew(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    const SymbolInfo* returnedType = nullptr;
+
+    Node* identifierNode = GetFirstChild(astRoot);
+    const Identifier* classIdentifier = GetClass(identifierNode, scopeAnalyzer);
+    if (classIdentifier != nullptr)
     {
-        returnedType = &scopeAnalyzer.GetThis()->symbolinfo;
+        returnedType = &classIdentifier->symbolinfo;
     }
-    else if (astRoot->value == N_STR_INDEX)
-    {
-        Node* arrNode = GetFirstChild(astRoot);
-        Node* indexNode = GetRightChild(astRoot);
 
-        const SymbolInfo* arrInfo = AnalyzeExpression(arrNode, scopeAnalyzer);
-        const SymbolInfo* indexInfo = AnalyzeExpression(indexNode, scopeAnalyzer);
+    return returnedType;
+}
 
-        if (indexInfo->type != T_STR_INT)
+static const SymbolInfo* AnalyzeNewArray(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    const SymbolInfo* returnedType = nullptr;
+
+    const SymbolInfo* sizeInfo = AnalyzeExpression(GetFirstChild(astRoot), scopeAnalyzer);
+    if (sizeInfo != nullptr)
+    {
+        if (sizeInfo->type != Atoms::INT)
         {
-            CompilerErr(indexNode, "Cannot index array with non-integer type '%s'.\n", indexInfo->type.c_str());
+            CompilerErr(astRoot, "Cannot create array of size using type '%s'. Size must be of type 'int'.\n", AtomCStr(sizeInfo->type));
         }
         else
         {
-            returnedType = &tempSymbolMap[T_STR_INT];
+            returnedType = &tempSymbolMap.at(Atoms::ARRAY);
         }
+    }
 
-        if (arrInfo != nullptr && indexInfo != nullptr)
-        {
-            if (arrInfo->type != T_STR_ARRAY)
-            {
-                CompilerErr(indexNode, "Cannot index non-array type '%s'.\n", arrInfo->type.c_str());
-            }
-        }
+    return returnedType;
+}
+
+static const SymbolInfo* AnalyzeLiteral(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    return &tempSymbolMap.at(GetLiteralType(astRoot));
+}
+
+static const SymbolInfo* AnalyzeThis(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    return &scopeAnalyzer.GetThis()->symbolinfo;
+}
+
+static const SymbolInfo* AnalyzeIndex(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    const SymbolInfo* returnedType = nullptr;
+
+    Node* arrNode = GetFirstChild(astRoot);
+    Node* indexNode = GetRightChild(astRoot);
+
+    const SymbolInfo* arrInfo = AnalyzeExpression(arrNode, scopeAnalyzer);
+    const SymbolInfo* indexInfo = AnalyzeExpression(indexNode, scopeAnalyzer);
+
+    if (indexInfo->type != Atoms::INT)
+    {
+        CompilerErr(indexNode, "Cannot index array with non-integer type '%s'.\n", AtomCStr(indexInfo->type));
     }
-    else if (astRoot->value == N_STR_LENGTH)
+    else
     {
-        const SymbolInfo* lengthInfo = AnalyzeExpression(GetFirstChild(astRoot), scopeAnalyzer);
-        Assert(lengthInfo != nullptr, "Length info is null.\n");
+        returnedType = &tempSymbolMap.at(Atoms::INT);
+    }
 
-        if (lengthInfo->type != T_STR_ARRAY)
-        {
-            CompilerErr(astRoot, "Cannot get length of non-array type '%s'.\n", lengthInfo->type.c_str());
-        }
-        else
+    if (arrInfo != nullptr && indexInfo != nullptr)
+    {
+        if (arrInfo->type != Atoms::ARRAY)
         {
-            returnedType = &tempSymbolMap[T_STR_INT];
+            CompilerErr(indexNode, "Cannot index non-array type '%s'.\n", AtomCStr(arrInfo->type));
         }
     }
 
     return returnedType;
 }
 
+static const SymbolInfo* AnalyzeLength(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    const SymbolInfo* returnedType = nullptr;
+
+    const SymbolInfo* lengthInfo = AnalyzeExpression(GetFirstChild(astRoot), scopeAnalyzer);
+    Assert(lengthInfo != nullptr, "Length info is null.\n");
+
+    if (lengthInfo->type != Atoms::ARRAY)
+    {
+        CompilerErr(astRoot, "Cannot get length of non-array type '%s'.\n", AtomCStr(lengthInfo->type));
+    }
+    else
+    {
+        returnedType = &tempSymbolMap.at(Atoms::INT);
+    }
+
+    return returnedType;
+}
+
+typedef const SymbolInfo* (*ExpressionAnalyzer)(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer);
+
+// The analyzer of each expression kind, indexed by node kind.
+static const std::array<ExpressionAnalyzer, (size_t)NodeKind::COUNT> expressionAnalyzers = []
+    {
+        std::array<ExpressionAnalyzer, (size_t)NodeKind::COUNT> analyzers = {};
+        analyzers[(size_t)NodeKind::IDENTIFIER] = AnalyzeIdentifier;
+        analyzers[(size_t)NodeKind::METHOD_CALL] = AnalyzeMethodCall;
+        analyzers[(size_t)NodeKind::BINARY_OPERATION] = AnalyzeBinaryOperation;
+        analyzers[(size_t)NodeKind::UNARY_OPERATION] = AnalyzeUnaryOperation;
+        analyzers[(size_t)NodeKind::NEW] = AnalyzeNew;
+        analyzers[(size_t)NodeKind::NEW_ARRAY] = AnalyzeNewArray;
+        analyzers[(size_t)NodeKind::INT_LITERAL] = AnalyzeLiteral;
+        analyzers[(size_t)NodeKind::BOOLEAN_LITERAL] = AnalyzeLiteral;
+        analyzers[(size_t)NodeKind::STRING_LITERAL] = AnalyzeLiteral;
+        analyzers[(size_t)NodeKind::THIS] = AnalyzeThis;
+        analyzers[(size_t)NodeKind::INDEX] = AnalyzeIndex;
+        analyzers[(size_t)NodeKind::LENGTH] = AnalyzeLength;
+        return analyzers;
+    }();
+
+// An expression always resolves to a type which is returned by this function.
+// An expression can be faulty, in which case it returns nullptr.
+const SymbolInfo* AnalyzeExpression(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer)
+{
+    ExpressionAnalyzer analyzer = expressionAnalyzers[(size_t)astRoot->kind];
+
+    return analyzer != nullptr ? analyzer(astRoot, scopeAnalyzer) : nullptr;
+}
+
 bool IsSameType(const SymbolInfo& a, const SymbolInfo& b)
 {
     return a.type == b.type;
@@ -560,11 +687,11 @@ const Identifier* GetVariable(const Node* identifierNode, ScopeAnalyzer& scopeAn
 
     if (variableIdentifier == nullptr)
     {
-        CompilerErr(identifierNode, "Variable '%s' is undefined in current scope.\n", GetIdentifierName(identifierNode)->c_str());
+        CompilerErr(identifierNode, "Variable '%s' is undefined in current scope.\n", AtomCStr(*GetIdentifierName(identifierNode)));
     }
     else if (identifierNode->lineno < variableIdentifier->symbolinfo.lineno)
     {
-        CompilerErr(identifierNode, "Variable '%s' is used before it is declared.\n", GetIdentifierName(identifierNode)->c_str());
+        CompilerErr(identifierNode, "Variable '%s' is used before it is declared.\n", AtomCStr(*GetIdentifierName(identifierNode)));
     }
 
     return variableIdentifier;
@@ -572,13 +699,13 @@ const Identifier* GetVariable(const Node* identifierNode, ScopeAnalyzer& scopeAn
 
 const Identifier* GetClass(const Node* identifierNode, ScopeAnalyzer& scopeAnalyzer)
 {
-    const std::string* identifierName = GetIdentifierName(identifierNode);
+    const Atom* identifierName = GetIdentifierName(identifierNode);
     Assert(identifierName != nullptr, "Identifier name is null.\n");
     const Identifier* classIdentifier = scopeAnalyzer.GetClass(*identifierName);
 
     if (classIdentifier == nullptr)
     {
-        CompilerErr(identifierNode, "Class '%s' is undefined in current scope.\n", identifierName->c_str());
+        CompilerErr(identifierNode, "Class '%s' is undefined in current scope.\n", AtomCStr(*identifierName));
     }
 
     return classIdentifier;
@@ -590,7 +717,7 @@ const Identifier* GetMethod(const Node* identifierNode, ScopeAnalyzer& scopeAnal
 
     if (methodIdentifier == nullptr)
     {
-        CompilerErr(identifierNode, "Method '%s' is undefined in current scope.\n", GetIdentifierName(identifierNode)->c_str());
+        CompilerErr(identifierNode, "Method '%s' is undefined in current scope.\n", AtomCStr(*GetIdentifierName(identifierNode)));
     }
 
     return methodIdentifier;
@@ -4,6 +4,9 @@
 #include "SymbolTable.h"
 #include "ScopeAnalyzer.h"
 
+// Analyze all classes of a program in parallel. Diagnostics are printed in source order.
+bool AnalyzeProgram(const Node* astRoot, const SymbolTable* symbolTableRoot);
+// Analyze a class or method declaration within the scopes already on the stack of the scope analyzer.
 bool AnalyzeStructure(const Node* astRoot, const SymbolTable* symbolTableRoot, ScopeAnalyzer& scopeAnalyzer);
 bool AnalyzeStatement(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer);
 const SymbolInfo* AnalyzeExpression(const Node* astRoot, ScopeAnalyzer& scopeAnalyzer);
@@ -0,0 +1,54 @@
+#include "SourceFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SourceFile::~SourceFile()
+{
+    if (mapping != nullptr)
+    {
+        munmap(mapping, size);
+    }
+}
+
+bool SourceFile::Open(const std::string& filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1)
+    {
+        close(fd);
+        return false;
+    }
+
+    size = (size_t)fileStat.st_size;
+
+    // Empty files can not be mapped, but are still valid input.
+    if (size == 0)
+    {
+        close(fd);
+        data = "";
+        return true;
+    }
+
+    mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the file is closed.
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        mapping = nullptr;
+        return false;
+    }
+
+    data = (const char*)mapping;
+
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+// A source file mapped into memory. The lexer reads straight from the mapping.
+struct SourceFile
+{
+    SourceFile() = default;
+    ~SourceFile();
+
+    SourceFile(const SourceFile&) = delete;
+    SourceFile& operator=(const SourceFile&) = delete;
+
+    bool Open(const std::string& filename);
+
+    const char* data = nullptr;
+    size_t size = 0;
+
+private:
+    void* mapping = nullptr;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Node.h"
+#include "NodeArena.h"
+
+// The state of one scanner. Every scanner owns its own state, so files can be lexed back to back or at the same time.
+struct LexerState
+{
+    const char* source;
+    size_t size;
+    size_t position; // Offset of the next character handed to the scanner.
+    bool lexicalErrors;
+};
+
+// Lex and parse a source buffer into a tree allocated in the arena.
+// Returns the root of the tree, or nullptr if the source could not be parsed.
+// Lexical errors are reported through lexicalErrors, as the parser may still succeed.
+Node* ParseSource(const char* source, size_t size, NodeArena& arena, bool& lexicalErrors);
+
+// Only lex a source buffer. Returns whether any lexical errors were found.
+bool LexSource(const char* source, size_t size);
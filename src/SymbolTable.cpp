@@ -24,6 +24,14 @@ const char* IdentifierRecordToString(SymbolRecord record)
     }
 }
 
+SymbolTable::~SymbolTable()
+{
+    for (SymbolTable* child : children)
+    {
+        delete child;
+    }
+}
+
 void SymbolTable::AddVariable(Identifier& varIdentifier)
 {
     variables.push_back(varIdentifier);
@@ -36,20 +44,80 @@ SymbolTable* SymbolTable::AddSymbolTable(Identifier& identifier, Node* astNode)
     return newSymbolTable;
 }
 
-SymbolTable* SymbolTable::GetChildWithName(const std::string* name) const
+SymbolTable* SymbolTable::GetChildWithName(const Atom* name) const
 {
     if (name != nullptr)
     {
-        for (SymbolTable* child : children)
+        auto it = childIndex.find(*name);
+        if (it != childIndex.end())
+        {
+            return it->second;
+        }
+    }
+
+    return nullptr;
+}
+
+// The key of a method in the class method index.
+static uint64_t ClassMethodKey(Atom className, Atom methodName)
+{
+    return ((uint64_t)className << 32) | methodName;
+}
+
+void SymbolTable::BuildIndex()
+{
+    identifierIndex.clear();
+    redeclarations.clear();
+    childIndex.clear();
+    identifierIndex.reserve(variables.size() + children.size());
+    childIndex.reserve(children.size());
+
+    auto addIdentifier = [&](const Identifier& identifier)
         {
-            if (child->identifier.symbol.GetName() == *name)
+            auto result = identifierIndex.emplace(identifier.symbol, &identifier);
+            if (!result.second)
             {
-                return child;
+                redeclarations.push_back(&identifier);
+                result.first->second = &identifier;
             }
+        };
+
+    for (const Identifier& variable : variables)
+    {
+        addIdentifier(variable);
+    }
+
+    for (SymbolTable* child : children)
+    {
+        addIdentifier(child->identifier);
+        childIndex.emplace(child->identifier.symbol.name, child);
+    }
+}
+
+void SymbolTable::BuildClassMethodIndex()
+{
+    classMethodIndex.clear();
+
+    for (const SymbolTable* classTable : children)
+    {
+        for (const SymbolTable* methodTable : classTable->children)
+        {
+            // Keep the first declaration, which is the one a linear search would find.
+            classMethodIndex.emplace(ClassMethodKey(classTable->identifier.symbol.name, methodTable->identifier.symbol.name), &methodTable->identifier);
         }
     }
+}
 
-    return nullptr;
+const Identifier* SymbolTable::FindIdentifier(const Symbol& symbol) const
+{
+    auto it = identifierIndex.find(symbol);
+    return it != identifierIndex.end() ? it->second : nullptr;
+}
+
+const Identifier* SymbolTable::FindClassMethod(Atom className, Atom methodName) const
+{
+    auto it = classMethodIndex.find(ClassMethodKey(className, methodName));
+    return it != classMethodIndex.end() ? it->second : nullptr;
 }
 
 void BuildSymbolTable(Node* root, SymbolTable* symbolTable)
@@ -59,26 +127,24 @@ void BuildSymbolTable(Node* root, SymbolTable* symbolTable)
 
     for (auto child : root->children)
     {
-        const std::string& nodeType = child->type;
-        const std::string& nodeValue = child->value;
-
-        if (nodeType == N_STR_CLASS_DECL || nodeType == N_STR_MAIN_CLASS)
+        if (child->kind == NodeKind::CLASS_DECL || child->kind == NodeKind::MAIN_CLASS)
         {
-            std::string& className = GetFirstChild(child)->value;
+            Atom className = GetFirstChild(child)->value;
 
             Identifier classIdentifier(className, scopeDepth, SymbolRecord::CLASS, child->lineno, className);
 
             // Add "this" to the symbol table when it is a class.
-            Identifier this_identifier(T_STR_THIS, scopeDepth + 1, SymbolRecord::VARIABLE, child->lineno, className);
+            Identifier this_identifier(Atoms::THIS, scopeDepth + 1, SymbolRecord::VARIABLE, child->lineno, className);
 
             SymbolTable* newSymbolTable = symbolTable->AddSymbolTable(classIdentifier, child);
             newSymbolTable->AddVariable(this_identifier);
 
             BuildSymbolTable(child, newSymbolTable);
+            newSymbolTable->BuildIndex();
         }
-        else if (nodeType == N_STR_METHOD_DECL)
+        else if (child->kind == NodeKind::METHOD_DECL)
         {
-            const std::string* methodName = GetMethodIdentifierName(child);
+            const Atom* methodName = GetMethodIdentifierName(child);
             const IdentifierDatatype* returnType = GetMethodExpectedReturnType(child);
             Identifier methodIdentifier(*methodName, scopeDepth, SymbolRecord::METHOD, child->lineno, *returnType);
 
@@ -94,6 +160,7 @@ void BuildSymbolTable(Node* root, SymbolTable* symbolTable)
 
             SymbolTable* newSymbolTable = symbolTable->AddSymbolTable(methodIdentifier, child);
             BuildSymbolTable(child, newSymbolTable);
+            newSymbolTable->BuildIndex();
         }
         else
         {
@@ -101,17 +168,21 @@ void BuildSymbolTable(Node* root, SymbolTable* symbolTable)
         }
     }
 
-    const std::string& nodeType = root->type;
-    const std::string& nodeValue = root->value;
-
-    if (nodeType == N_STR_VARIABLE)
+    if (root->kind == NodeKind::VARIABLE)
     {
-        IdentifierDatatype varType = nodeValue;
-        std::string varName = GetChildAtIndex(root, 0)->value;
+        IdentifierDatatype varType = root->value;
+        Atom varName = GetChildAtIndex(root, 0)->value;
 
         Identifier varIdentifier(varName, scopeDepth, SymbolRecord::VARIABLE, root->lineno, varType);
         symbolTable->AddVariable(varIdentifier);
     }
+
+    // Class and method tables are indexed above once they are complete, the global table is complete here.
+    if (root->kind == NodeKind::PROGRAM)
+    {
+        symbolTable->BuildIndex();
+        symbolTable->BuildClassMethodIndex();
+    }
 }
 
 void PrintDepthIndent(int depth)
@@ -124,7 +195,7 @@ void PrintDepthIndent(int depth)
 
 void PrintIdentifierRaw(Identifier& identifier, int depth)
 {
-    PrintRaw("%d - %s\n", identifier.symbolinfo.lineno, identifier.symbol.name.c_str());
+    PrintRaw("%d - %s\n", identifier.symbolinfo.lineno, identifier.symbol.GetName());
 }
 
 void PrintIdentifier(const std::string& prefix, Identifier& identifier, int depth)
@@ -169,7 +240,7 @@ void PrintSymbolTable(SymbolTable* symbolTable, int depth/*=0*/)
     for (auto variable : symbolTable->variables)
     {
         // Don't print "this" as a variable.
-        if (variable.symbol.name != T_STR_THIS)
+        if (variable.symbol.name != Atoms::THIS)
             PrintVariableIdentifier(variable, depth + 1);
     }
 
@@ -3,8 +3,10 @@
 #include <string>
 #include <functional> // std::hash
 #include <cstdint>
+#include <unordered_map>
 
 #include "Node.h"
+#include "Atom.h"
 
 typedef uint32_t SymbolRecordType; 
 enum class SymbolRecord : SymbolRecordType
@@ -18,25 +20,26 @@ enum class SymbolRecord : SymbolRecordType
 
 const char* IdentifierRecordToString(SymbolRecord record);
 
-typedef std::string IdentifierDatatype;
-constexpr char* NO_TYPE = "(typeless)";
+// The atom of the name of the type.
+typedef Atom IdentifierDatatype;
+constexpr IdentifierDatatype NO_TYPE = Atoms::NO_TYPE;
 
 struct Symbol{
 
     Symbol()
-        : name("NULL SYMBOL"), record(SymbolRecord::UNKNOWN) {}
+        : name(Intern("NULL SYMBOL")), record(SymbolRecord::UNKNOWN) {}
 
-    Symbol(std::string name, uint32_t scopeDepth, SymbolRecord record)
+    Symbol(Atom name, uint32_t scopeDepth, SymbolRecord record)
         : name(name), scopeDepth(scopeDepth), record(record) {}
 
     bool operator==(const Symbol& other) const
     {
-        return name == other.name && record == other.record;
+        return name == other.name && scopeDepth == other.scopeDepth && record == other.record;
     }
 
     const char* GetName() const
     {
-        return name.c_str();
+        return AtomCStr(name);
     }
 
     const char* GetRecord() const
@@ -49,11 +52,23 @@ struct Symbol{
         return std::string(GetRecord()) + " " + GetName();
     }
 
-    std::string name;
+    Atom name;
     uint32_t scopeDepth;
     SymbolRecord record;
 };
 
+// Hash all fields of a symbol. Each field is multiplied by its own odd constant,
+// so symbols that only differ in their record or scope depth still get unrelated hashes.
+inline std::size_t HashSymbol(const Symbol& symbol)
+{
+    uint64_t h = (uint64_t)symbol.name * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)symbol.scopeDepth * 0xC2B2AE3D27D4EB4Full;
+    h ^= (uint64_t)symbol.record * 0x165667B19E3779F9ull;
+
+    // The high bits are the best mixed. Fold them down for tables that index with the low bits.
+    return (std::size_t)(h ^ (h >> 32));
+}
+
 // Custom hash function for Symbol. This is necessary to use Symbol as a key in a std::unordered_map.
 namespace std
 {
@@ -62,11 +77,7 @@ namespace std
     {
         std::size_t operator()(const Symbol& symbol) const
         {
-            std::size_t h1 = std::hash<std::string>()(symbol.name);
-            std::size_t h2 = std::hash<SymbolRecordType>()(static_cast<SymbolRecordType>(symbol.record));
-            std::size_t h3 = std::hash<uint32_t>()(symbol.scopeDepth);
-
-            return h1 ^ (h2 << 1) ^ (h3 << 1);
+            return HashSymbol(symbol);
         }
     };
 }
@@ -79,9 +90,6 @@ struct SymbolInfo
     SymbolInfo(int lineno, IdentifierDatatype type)
         : lineno(lineno), type(type) {}
 
-    SymbolInfo(const Node* node)
-        : lineno(node->lineno), type(node->type) {}
-
     bool operator==(const SymbolInfo& other) const
     {
         return lineno == other.lineno && type == other.type;
@@ -97,7 +105,7 @@ struct Identifier
     Identifier() 
         : symbol(), symbolinfo() {}
 
-    Identifier(std::string name, uint32_t scopeDepth, SymbolRecord record, int lineno, IdentifierDatatype type)
+    Identifier(Atom name, uint32_t scopeDepth, SymbolRecord record, int lineno, IdentifierDatatype type)
         : symbol(name, scopeDepth, record), symbolinfo(lineno, type) {}
 
     Identifier(Symbol symbol, SymbolInfo symbolinfo)
@@ -121,16 +129,39 @@ struct SymbolTable{
 
     SymbolTable(Identifier identifier, Node* astNode, SymbolTable* parent)
         : identifier(identifier), astNode(astNode) {}
+    // Deletes the child tables.
+    ~SymbolTable();
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
 
     void AddVariable(Identifier& identifier);
     SymbolTable* AddSymbolTable(Identifier& identifier, Node* astNode);
-    SymbolTable* GetChildWithName(const std::string* name) const;
+    SymbolTable* GetChildWithName(const Atom* name) const;
+
+    // Index the variables and children of this table. Called once the table is complete.
+    void BuildIndex();
+    // Index the methods of every class in this table. Called on the global table once all classes are indexed.
+    void BuildClassMethodIndex();
+    // Find an identifier declared directly in this table. The symbol must have the scope depth of the table.
+    const Identifier* FindIdentifier(const Symbol& symbol) const;
+    // Find a method of a class in this table.
+    const Identifier* FindClassMethod(Atom className, Atom methodName) const;
 
     Identifier identifier;
     Node* astNode; // The node in the AST that this symbol table represents.
 
     std::vector<Identifier> variables;
     std::vector<SymbolTable*> children;
+
+    // The identifiers declared in this table. Identifiers that are declared twice map to their last declaration.
+    std::unordered_map<Symbol, const Identifier*> identifierIndex;
+    // The identifiers that redeclare an identifier of this table, in declaration order.
+    std::vector<const Identifier*> redeclarations;
+    // The children of this table by name. Children that share a name map to the first one.
+    std::unordered_map<Atom, SymbolTable*> childIndex;
+    // The methods of the classes in this table, keyed by class and method name. Only built for the global table.
+    std::unordered_map<uint64_t, const Identifier*> classMethodIndex;
 };
 
 void BuildSymbolTable(Node* root, SymbolTable* symbolTable);
@@ -1,4 +1,5 @@
 #include "TAC.h"
+#include "ConsolePrinter.h"
 #include "CompilerStringDefines.h"
 #include "BytecodeContainer.h"
 
@@ -7,12 +8,12 @@
 
 void TAC::dump()
 {
-    printf("%s := %s %s %s\n", result.c_str(), arg1.c_str(), op.c_str(), arg2.c_str());
+    PrintRaw("%s := %s %s %s\n", AtomCStr(result), AtomCStr(arg1), AtomCStr(op), AtomCStr(arg2));
 }
 
 void TACExpression::GenerateBytecode(BytecodeContainer& bytecodeInstructions)
 {
-    if (!arg1.empty())
+    if (arg1 != Atoms::EMPTY)
     {
         bytecodeInstructions.AddLoad(arg1);
     }
@@ -22,19 +23,16 @@ void TACExpression::GenerateBytecode(BytecodeContainer& bytecodeInstructions)
 
 void TACMethodCall::GenerateBytecode(BytecodeContainer& bytecodeInstructions)
 {
-    size_t args = std::stoi(arg2);
-    size_t callerParamIndex = bytecodeInstructions.size() - args;
-    const std::string& callerParam = bytecodeInstructions.at(callerParamIndex);
-    std::string callerName = callerParam.substr(callerParam.find(" ") + 1);
-
-    bytecodeInstructions.AddInvokeVirtual(callerName, arg1).AddStore(result);
-
-    // Save the index of the first parameter of the call.
-    bytecodeInstructions.firstCallParamIndices.push_back(callerParamIndex);
+    bytecodeInstructions.AddInvokeVirtual(callerParam->result, arg1).AddStore(result);
 }
 
 void TACParam::GenerateBytecode(BytecodeContainer& bytecodeInstructions)
 {
+    if (isCaller)
+    {
+        return;
+    }
+
     bytecodeInstructions.AddLoad(result);
 }
 
@@ -86,13 +84,86 @@ void TACReturn::GenerateBytecode(BytecodeContainer& bytecodeInstructions)
 void TACSystemPrint::GenerateBytecode(BytecodeContainer& bytecodeInstructions)
 {
     // This is enough according to the slides for bytecode generation.
-    bytecodeInstructions.AddLoad(result).AddAny("print");
+    bytecodeInstructions.AddLoad(result).Add(BytecodeInstruction::IPRINT);
 }
 
 void TACStop::GenerateBytecode(BytecodeContainer& bytecodeInstructions)
 {
     // This is enough according to the slides for bytecode generation.
-    bytecodeInstructions.AddAny("stop");
+    bytecodeInstructions.Add(BytecodeInstruction::STOP);
+}
+
+
+// ----- REGISTER CODE GENERATION FUNCTIONS START HERE -----
+
+
+void TACExpression::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    registerInstructions.AddOperator(op, result, arg1, arg2);
+}
+
+void TACMethodCall::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    registerInstructions.AddCall(result, arg1);
+}
+
+void TACParam::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    registerInstructions.AddParam(result);
+}
+
+void TACArg::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    registerInstructions.Add(RegisterInstruction::POP, registerInstructions.GetRegister(result));
+}
+
+void TACJump::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    registerInstructions.AddJump(result);
+}
+
+void TACLength::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    registerInstructions.Add(RegisterInstruction::NOT_IMPLEMENTED);
+}
+
+void TACNew::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    // Objects carry no state, so only their class is needed to bind calls on them.
+    registerInstructions.AddObject(result, arg2);
+}
+
+void TACNewArr::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    registerInstructions.Add(RegisterInstruction::NOT_IMPLEMENTED);
+}
+
+void TACArrIndex::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    registerInstructions.Add(RegisterInstruction::NOT_IMPLEMENTED);
+}
+
+void TACAssign::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    registerInstructions.AddAssign(result, arg1);
+}
+
+void TACAssignIndexed::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    registerInstructions.Add(RegisterInstruction::NOT_IMPLEMENTED);
+}
+
+void TACReturn::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    registerInstructions.Add(RegisterInstruction::RETURN, registerInstructions.GetRegister(result));
 }
 
+void TACSystemPrint::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    registerInstructions.Add(RegisterInstruction::PRINT, registerInstructions.GetRegister(result));
+}
 
+void TACStop::GenerateRegisterCode(RegisterContainer& registerInstructions)
+{
+    registerInstructions.Add(RegisterInstruction::STOP);
+}
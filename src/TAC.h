@@ -3,147 +3,173 @@
 #include <string>
 #include <vector>
 
+#include "Atom.h"
 #include "BytecodeContainer.h"
+#include "RegisterContainer.h"
 
 struct TAC
 {
-    TAC(std::string result, std::string arg1, std::string op, std::string arg2)
+    TAC(Atom result, Atom arg1, Atom op, Atom arg2)
         : result(result), arg1(arg1), op(op), arg2(arg2)
     {}
+    virtual ~TAC() = default;
 
     virtual void GenerateBytecode(BytecodeContainer& bytecodeInstructions) = 0;
+    virtual void GenerateRegisterCode(RegisterContainer& registerInstructions) = 0;
     void dump();
 
-    std::string result;
-    std::string arg1;
-    std::string op;
-    std::string arg2;
+    Atom result;
+    Atom arg1;
+    Atom op;
+    Atom arg2;
 };
 
 struct TACExpression : public TAC
 {
-    TACExpression(std::string result, std::string arg1, std::string op, std::string arg2)
+    TACExpression(Atom result, Atom arg1, Atom op, Atom arg2)
         : TAC(result, arg1, op, arg2)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
 };
 
+struct TACParam;
+
 struct TACMethodCall : public TAC
 {
-    TACMethodCall(std::string result, std::string methodName, std::string N)
-        : TAC(result, methodName, "call", N)
+    TACMethodCall(Atom result, Atom methodName, Atom N, TACParam* callerParam)
+        : TAC(result, methodName, Atoms::TAC_CALL, N), callerParam(callerParam)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
+
+    // The first parameter of the call, which holds the caller.
+    TACParam* callerParam;
 };
 
 struct TACParam : public TAC
 {
-    TACParam(std::string param)
-        : TAC(param, "", "param", "")
+    TACParam(Atom param, bool isCaller = false)
+        : TAC(param, Atoms::EMPTY, Atoms::TAC_PARAM, Atoms::EMPTY), isCaller(isCaller)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
+
+    // The caller is only passed as a parameter in the IR. The bytecode binds it into the call instead.
+    bool isCaller;
 };
 
 struct TACArg : public TAC
 {
-    TACArg(std::string arg)
-        : TAC(arg, "", "arg", "")
+    TACArg(Atom arg)
+        : TAC(arg, Atoms::EMPTY, Atoms::TAC_ARG, Atoms::EMPTY)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
 };
 
 struct TACJump : public TAC
 {
-    TACJump(std::string label)
-        : TAC(label, "", "jump", "")
+    TACJump(Atom label)
+        : TAC(label, Atoms::EMPTY, Atoms::TAC_JUMP, Atoms::EMPTY)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
 };
 
 struct TACLength : public TAC
 {
-    TACLength(std::string result, std::string arg1)
-        : TAC(result, "", "length", arg1)
+    TACLength(Atom result, Atom arg1)
+        : TAC(result, Atoms::EMPTY, Atoms::TAC_LENGTH, arg1)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
 };
 
 struct TACNew : public TAC
 {
-    TACNew(std::string result, std::string arg1)
-        : TAC(result, "", "new", arg1)
+    TACNew(Atom result, Atom arg1)
+        : TAC(result, Atoms::EMPTY, Atoms::TAC_NEW, arg1)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
 };
 
 struct TACNewArr : public TAC
 {
-    TACNewArr(std::string result, std::string arrName, std::string N)
-        : TAC(result, arrName, "newArr", N)
+    TACNewArr(Atom result, Atom arrName, Atom N)
+        : TAC(result, arrName, Atoms::TAC_NEW_ARR, N)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
 };
 
 struct TACArrIndex : public TAC
 {
-    TACArrIndex(std::string result, std::string arrName, std::string index)
-        : TAC(result, arrName, "[]", index)
+    TACArrIndex(Atom result, Atom arrName, Atom index)
+        : TAC(result, arrName, Atoms::TAC_INDEX, index)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
 };
 
 struct TACAssign : public TAC
 {
-    TACAssign(std::string result, std::string arg1)
-        : TAC(result, arg1, "", "")
+    TACAssign(Atom result, Atom arg1)
+        : TAC(result, arg1, Atoms::EMPTY, Atoms::EMPTY)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
 };
 
 struct TACAssignIndexed : public TAC
 {
-    TACAssignIndexed(std::string arrName, std::string index, std::string value)
-        : TAC(arrName, index, "[]=", value)
+    TACAssignIndexed(Atom arrName, Atom index, Atom value)
+        : TAC(arrName, index, Atoms::TAC_ASSIGN_INDEXED, value)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
 };
 
 struct TACReturn : public TAC
 {
-    TACReturn(std::string result)
-        : TAC(result, "", "return", "")
+    TACReturn(Atom result)
+        : TAC(result, Atoms::EMPTY, Atoms::TAC_RETURN, Atoms::EMPTY)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
 };
 
 struct TACSystemPrint : public TAC
 {
-    TACSystemPrint(std::string arg1)
-        : TAC(arg1, "", "system.print", "")
+    TACSystemPrint(Atom arg1)
+        : TAC(arg1, Atoms::EMPTY, Atoms::TAC_PRINT, Atoms::EMPTY)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
 };
 
 struct TACStop : public TAC
 {
     TACStop()
-        : TAC("", "", "stop", "")
+        : TAC(Atoms::EMPTY, Atoms::EMPTY, Atoms::TAC_STOP, Atoms::EMPTY)
     {}
 
     void GenerateBytecode(BytecodeContainer& bytecodeInstructions) override;
+    void GenerateRegisterCode(RegisterContainer& registerInstructions) override;
 };
 
 
@@ -1,66 +1,62 @@
 #include <stdio.h>
 #include <assert.h>
 #include <iostream>
-
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "ConsolePrinter.h"
 #include "Node.h"
+#include "NodeArena.h"
 #include "SymbolTable.h"
-#include "ScopeAnalyzer.h"
-#include "minijava_parser.tab.hh"
+#include "SourceFile.h"
+#include "SourceParser.h"
+#include "ParallelFor.h"
 #include "SemanticAnalyzer.h"
 #include "NodeHelperFunctions.h"
 
 #include "ControlFlowGraph.h"
 #include "ControlFlowGraphHandler.h"
 #include "BytecodeInterpreter.h"
+#include "RegisterInterpreter.h"
 
 #ifndef USE_LEX_ONLY
 #define USE_LEX_ONLY 0
 #endif
 
-#if YYDEBUG
-int yydebug;
-#else
-static int yydebug = 0;
-#endif
-
-extern int yylex();
-extern FILE* yyin;
-extern int lexical_errors;
-extern Node* rootNode;
-
-int main(int argc, char* argv[])
+struct CompileOptions
 {
-#if YYDEBUG
-    yydebug = 1;
-#endif
+    bool useRegisterVM = false;
+    bool writeDisassembly = false;
+    bool writeBytecode = false;
+};
 
-    if (argc < 2)
-    {
-        fprintf(stderr, "ERROR: Must have input file. Usage: ./compiler test_file_path\n");
-        return 1;
-    }
-
-    yy::parser parser;
+// Compile and run one file. The names of the files written along the way are prefixed with outputPrefix.
+static int CompileFile(const char* filePath, const CompileOptions& options, const std::string& outputPrefix)
+{
+    // Owns the syntax tree until the file has been compiled.
+    NodeArena nodeArena;
 
-    // Open input file
-    const char* file_path = argv[1];
-    FILE* file = fopen(file_path, "r");
-    if (file == NULL)
+    // Map the input file so the lexer can read it in place.
+    SourceFile sourceFile;
+    if (!sourceFile.Open(filePath))
     {
-        fprintf(stderr, "ERROR: File '%s' not found.\n", file_path);
+        PrintRawErr("ERROR: File '%s' not found.\n", filePath);
         return 1;
     }
-    // Set input file for parsing/lexing
-    yyin = file;
 
     // Return value for main
     int returnVal = 0;
 
     if (USE_LEX_ONLY)
     {
-        yylex();
+        bool lexicalErrors = LexSource(sourceFile.data, sourceFile.size);
 
-        if (lexical_errors)
+        if (lexicalErrors)
         {
             returnVal = 1;
             goto CLEANUP;
@@ -68,9 +64,11 @@ int main(int argc, char* argv[])
     }
     else
     {
-        bool parseSuccess = !parser.parse();
+        bool lexicalErrors = false;
+        Node* rootNode = ParseSource(sourceFile.data, sourceFile.size, nodeArena, lexicalErrors);
+        bool parseSuccess = rootNode != nullptr;
 
-        if (lexical_errors)
+        if (lexicalErrors)
         {
             returnVal = 1;
             goto CLEANUP;
@@ -80,42 +78,66 @@ int main(int argc, char* argv[])
         {
             //printf("Printing tree:\n");
             //rootNode->print_tree();
-            printf("\nGenerating tree...");
-            rootNode->generate_tree();
-            printf("Tree generated.\n");
-
-            printf("Creating symbol table...\n");
-            SymbolTable* rootSymbolTable = new SymbolTable(Identifier("global", (-1u), SymbolRecord::UNKNOWN, 0, NO_TYPE), rootNode, nullptr);
+            PrintRaw("\nGenerating tree...");
+            rootNode->generate_tree(outputPrefix + "tree.dot");
+            PrintRaw("Tree generated.\n");
+
+            PrintRaw("Creating symbol table...\n");
+            // The root table owns every other table of the program.
+            std::unique_ptr<SymbolTable> rootSymbolTableOwner = std::make_unique<SymbolTable>(Identifier(Intern("global"), (-1u), SymbolRecord::UNKNOWN, 0, NO_TYPE), rootNode, nullptr);
+            SymbolTable* rootSymbolTable = rootSymbolTableOwner.get();
             BuildSymbolTable(rootNode, rootSymbolTable);
-            printf("Symbol table created.\n");
+            PrintRaw("Symbol table created.\n");
             //PrintSymbolTable(rootSymbolTable);
 
-            ScopeAnalyzer scopeAnalyzer;
-            printf("\n");
-            bool validStructure = AnalyzeStructure(rootNode, rootSymbolTable, scopeAnalyzer);
+            PrintRaw("\n");
+            bool validStructure = AnalyzeProgram(rootNode, rootSymbolTable);
 
             if (validStructure)
             {
                 CFGHandler cfgHandler;
                 cfgHandler.ConstructCFG(rootSymbolTable);
 
-                std::string cfgFileName = "CFG.dot";
+                std::string cfgFileName = outputPrefix + "CFG.dot";
                 cfgHandler.GenerateDOT(cfgFileName);
 
+                if (options.useRegisterVM)
+                {
+                    RegisterContainer registerInstructions;
+                    cfgHandler.GenerateRegisterCode(registerInstructions);
+                    registerInstructions.WriteToFile(outputPrefix + "registercode.txt");
+
+                    RegisterInterpreter interpreter;
+                    interpreter.Interpret(registerInstructions);
+                    goto CLEANUP;
+                }
+
                 BytecodeContainer bytecodeInstructions;
                 cfgHandler.GenerateBytecode(bytecodeInstructions);
-                std::string bytecodeFileName = "bytecode.txt";
-                bool writeSuccess = bytecodeInstructions.WriteToFile(bytecodeFileName);
 
-                if (!writeSuccess)
+                BytecodeProgram bytecodeProgram;
+                bytecodeProgram.Assemble(bytecodeInstructions);
+
+                if (options.writeDisassembly)
                 {
-                    printf("Failed to generate bytecode file.\n");
-                    returnVal = 1;
-                    goto CLEANUP;
+                    bytecodeProgram.GetView().WriteDisassembly(outputPrefix + "bytecode.txt");
+                }
+
+                if (options.writeBytecode)
+                {
+                    bool writeSuccess = bytecodeProgram.WriteToFile(outputPrefix + "bytecode.bin");
+
+                    if (!writeSuccess)
+                    {
+                        PrintRaw("Failed to generate bytecode file.\n");
+                        returnVal = 1;
+                        goto CLEANUP;
+                    }
                 }
 
+                // The generated program is run directly, the bytecode file is only written for inspection.
                 BytecodeInterpreter interpreter;
-                interpreter.Interpret(bytecodeFileName);
+                interpreter.Interpret(bytecodeProgram);
 
                 /*
 
@@ -147,14 +169,14 @@ int main(int argc, char* argv[])
             }
             else
             {
-                printf("Semantic analysis failed. No control flow graph will be generated.\n");
+                PrintRaw("Semantic analysis failed. No control flow graph will be generated.\n");
                 returnVal = 1;
                 goto CLEANUP;
             }
         }
         else
         {
-            printf("Parse failed. No semantic analysis will be performed.\n");
+            PrintRaw("Parse failed. No semantic analysis will be performed.\n");
             returnVal = 1;
             goto CLEANUP;
         }
@@ -162,7 +184,249 @@ int main(int argc, char* argv[])
 
 
 CLEANUP:
-    fclose(file);
-    printf("Exiting...\n\n");
+    PrintRaw("Exiting...\n\n");
     return returnVal;
-}
\ No newline at end of file
+}
+
+// Run a bytecode file written by --write-bytecode without compiling anything.
+static int RunBytecodeFile(const char* filePath)
+{
+    BytecodeInterpreter interpreter;
+    bool runSuccess = interpreter.Interpret(std::string(filePath));
+
+    PrintRaw("Exiting...\n\n");
+    return runSuccess ? 0 : 1;
+}
+
+struct BatchJob
+{
+    std::string filePath;
+    std::string outputDirectory;
+    int returnVal = 0;
+};
+
+// Expand the batch inputs into the files to compile. Directories contribute the .java files directly inside them.
+static bool CollectBatchFiles(const std::vector<std::string>& inputs, std::vector<std::string>& files)
+{
+    for (const std::string& input : inputs)
+    {
+        std::error_code error;
+        if (!std::filesystem::is_directory(input, error))
+        {
+            files.push_back(input);
+            continue;
+        }
+
+        std::vector<std::string> directoryFiles;
+        for (const auto& entry : std::filesystem::directory_iterator(input, error))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".java")
+            {
+                directoryFiles.push_back(entry.path().string());
+            }
+        }
+
+        if (error)
+        {
+            PrintRawErr("ERROR: Could not read directory '%s'.\n", input.c_str());
+            return false;
+        }
+
+        // Directory order is unspecified, sort it so batches are reproducible.
+        std::sort(directoryFiles.begin(), directoryFiles.end());
+        files.insert(files.end(), directoryFiles.begin(), directoryFiles.end());
+    }
+
+    return true;
+}
+
+// Compile one file of a batch with the output and diagnostics of the calling thread redirected into the job's directory.
+static void RunBatchJob(BatchJob& job, const CompileOptions& options)
+{
+    std::error_code error;
+    std::filesystem::create_directories(job.outputDirectory, error);
+
+    std::string outputPrefix = job.outputDirectory + "/";
+    FILE* outputFile = fopen((outputPrefix + "output.txt").c_str(), "w");
+    FILE* diagnosticsFile = fopen((outputPrefix + "diagnostics.txt").c_str(), "w");
+
+    if (outputFile == nullptr || diagnosticsFile == nullptr)
+    {
+        PrintRawErr("ERROR: Could not create the output files of '%s' in '%s'.\n", job.filePath.c_str(), job.outputDirectory.c_str());
+        job.returnVal = 1;
+    }
+    else
+    {
+        ConsoleStreams& streams = GetConsoleStreams();
+        ConsoleStreams previousStreams = streams;
+        streams.out = outputFile;
+        streams.err = diagnosticsFile;
+        // An internal error in one file must not take down the rest of the batch.
+        streams.throwOnAssert = true;
+
+        try
+        {
+            job.returnVal = CompileFile(job.filePath.c_str(), options, outputPrefix);
+        }
+        catch (const AssertionFailure& failure)
+        {
+            PrintRawErr("\nAssertion '%s' failed. Compilation aborted.\n", failure.what());
+            job.returnVal = 1;
+        }
+        catch (const std::exception& exception)
+        {
+            PrintRawErr("\nCompilation aborted: %s\n", exception.what());
+            job.returnVal = 1;
+        }
+
+        streams = previousStreams;
+    }
+
+    if (outputFile != nullptr)
+    {
+        fclose(outputFile);
+    }
+    if (diagnosticsFile != nullptr)
+    {
+        fclose(diagnosticsFile);
+    }
+}
+
+// Compile every input file on a pool of worker threads. Each file gets its own directory below outputDirectory
+// holding its generated files, its output (output.txt) and its diagnostics (diagnostics.txt).
+static int RunBatch(const std::vector<std::string>& inputs, const CompileOptions& options, const std::string& outputDirectory, unsigned threadCount)
+{
+    std::vector<std::string> files;
+    if (!CollectBatchFiles(inputs, files))
+    {
+        return 1;
+    }
+
+    // Name the job directories after the files, numbering files that share a name. A numbered name can itself be
+    // the name of another file (Foo_2.java), so every name is checked against all names taken so far.
+    std::vector<BatchJob> jobs(files.size());
+    std::unordered_set<std::string> takenNames;
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        std::string stem = std::filesystem::path(files[i]).stem().string();
+        std::string name = stem;
+        for (int number = 2; !takenNames.insert(name).second; number++)
+        {
+            name = stem + "_" + std::to_string(number);
+        }
+
+        jobs[i].filePath = files[i];
+        jobs[i].outputDirectory = outputDirectory + "/" + name;
+    }
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = (unsigned)std::min<size_t>(threadCount, std::max<size_t>(jobs.size(), 1));
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    ParallelFor(jobs.size(), [&](size_t i) { RunBatchJob(jobs[i], options); }, threadCount);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    size_t failedJobs = 0;
+    for (const BatchJob& job : jobs)
+    {
+        if (job.returnVal != 0)
+        {
+            failedJobs++;
+        }
+
+        printf("%-8s %s -> %s\n", job.returnVal == 0 ? "OK" : "FAILED", job.filePath.c_str(), job.outputDirectory.c_str());
+    }
+
+    printf("\nCompiled %zu files (%zu failed) in %.3f s on %u threads.\n", jobs.size(), failedJobs, seconds, threadCount);
+    return failedJobs == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+    // Parse options and input files
+    CompileOptions options;
+    std::vector<std::string> inputs;
+    bool batchMode = false;
+    unsigned threadCount = 0;
+    std::string outputDirectory = "batch_output";
+    std::string bytecodeFile;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--register-vm")
+        {
+            options.useRegisterVM = true;
+        }
+        else if (arg == "--disassemble")
+        {
+            options.writeDisassembly = true;
+        }
+        else if (arg == "--write-bytecode")
+        {
+            options.writeBytecode = true;
+        }
+        else if (arg == "--batch")
+        {
+            batchMode = true;
+        }
+        else if ((arg == "--jobs" || arg == "--output-dir" || arg == "--run-bytecode") && i + 1 == argc)
+        {
+            fprintf(stderr, "ERROR: Option '%s' expects a value.\n", argv[i]);
+            return 1;
+        }
+        else if (arg == "--jobs")
+        {
+            threadCount = (unsigned)std::max(0, atoi(argv[++i]));
+        }
+        else if (arg == "--output-dir")
+        {
+            outputDirectory = argv[++i];
+        }
+        else if (arg == "--run-bytecode")
+        {
+            bytecodeFile = argv[++i];
+        }
+        else if (arg.rfind("--", 0) == 0)
+        {
+            fprintf(stderr, "ERROR: Unknown option '%s'.\n", argv[i]);
+            return 1;
+        }
+        else
+        {
+            inputs.push_back(arg);
+        }
+    }
+
+    if (!bytecodeFile.empty())
+    {
+        return RunBytecodeFile(bytecodeFile.c_str());
+    }
+
+    if (inputs.empty())
+    {
+        fprintf(stderr, "ERROR: Must have input file. Usage: ./compiler [--register-vm] [--disassemble] [--write-bytecode] test_file_path\n"
+                        "       or: ./compiler --batch [--jobs N] [--output-dir DIR] [options] files_or_directories...\n"
+                        "       or: ./compiler --run-bytecode bytecode_file\n");
+        return 1;
+    }
+
+    if (batchMode)
+    {
+        return RunBatch(inputs, options, outputDirectory, threadCount);
+    }
+
+    // Without --batch a single file is compiled, with its files written to the working directory.
+    if (inputs.size() > 1)
+    {
+        fprintf(stderr, "ERROR: Only one input file can be compiled at a time. Use --batch to compile several files.\n");
+        return 1;
+    }
+
+    return CompileFile(inputs.front().c_str(), options, "");
+}
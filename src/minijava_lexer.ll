@@ -1,23 +1,39 @@
 %{
     #include <stdio.h>
     #include <assert.h>
+    #include <string.h>
     #include "minijava_parser.tab.hh"
     #include "Node.h"
-
-    extern Node* rootNode;
-    int lexical_errors = 0;
-
-    #define YY_DECL yy::parser::symbol_type yylex()
+    #include "Atom.h"
+    #include "SourceParser.h"
+    #include "ConsolePrinter.h"
+
+    #define YY_DECL yy::parser::symbol_type yylex(yyscan_t yyscanner)
+
+    // Hand the scanner the next chunk of the source buffer.
+    #define YY_INPUT(buf, result, max_size) \
+        { \
+            size_t remaining = yyextra->size - yyextra->position; \
+            size_t count = remaining < (size_t)max_size ? remaining : (size_t)max_size; \
+            memcpy(buf, yyextra->source + yyextra->position, count); \
+            yyextra->position += count; \
+            result = count; \
+        }
 
     #define USE_LEX_ONLY 0
     #define PRINT_TREE 0
 
-    #define REGISTER_TOKEN(token) if(USE_LEX_ONLY) { printf("%s ", #token); if(#token == "IDENTIFIER"){ printf("'%s' ", yytext); } } else { return yy::parser::make_##token(yytext); }
+    #define REGISTER_TOKEN(token) if(USE_LEX_ONLY) { PrintRaw("%s ", #token); } else { return yy::parser::make_##token(); }
+    // Tokens whose text is kept pass it on interned.
+    #define REGISTER_ATOM_TOKEN(token) if(USE_LEX_ONLY) { PrintRaw("%s ", #token); if(#token == "IDENTIFIER"){ PrintRaw("'%s' ", yytext); } } else { return yy::parser::make_##token(Intern(yytext)); }
     
     
 %}
 
+%option reentrant
+%option noyywrap
 %option yylineno
+%option extra-type="LexerState*"
 
 NUMBER_PTRN [0-9]
 LETTER_PTRN [a-zA-Z]
@@ -26,7 +42,7 @@ ALPHANUM_PTRN [a-zA-Z0-9_]
 %% 
 
 "System.out.println"                        { REGISTER_TOKEN(SYS_PRINT); }
-"main"                                      { REGISTER_TOKEN(MAIN); }
+"main"                                      { REGISTER_ATOM_TOKEN(MAIN); }
 "length"                                    { REGISTER_TOKEN(LENGTH); }
 
 "="                                         { REGISTER_TOKEN(EQU); }
@@ -34,7 +50,7 @@ ALPHANUM_PTRN [a-zA-Z0-9_]
 "int[]"                                     { REGISTER_TOKEN(T_ARR); }
 "boolean"                                   { REGISTER_TOKEN(T_BOOLEAN); }
 "String"                                    { REGISTER_TOKEN(T_STRING); }
-"void"                                      { REGISTER_TOKEN(T_VOID); }
+"void"                                      { REGISTER_ATOM_TOKEN(T_VOID); }
 
 "public"                                    { REGISTER_TOKEN(PUBLIC); }
 "static"                                    { REGISTER_TOKEN(STATIC); }
@@ -75,12 +91,43 @@ ALPHANUM_PTRN [a-zA-Z0-9_]
 ";"                                         { REGISTER_TOKEN(SEMI_COLON); }
 
 "//"[^\n]*                                  { /* NOP */ }
-"true"|"false"                              { REGISTER_TOKEN(BOOLEAN); }
-0|[1-9]{NUMBER_PTRN}*                       { REGISTER_TOKEN(INTEGER); }
-{LETTER_PTRN}({ALPHANUM_PTRN}|$)*           { REGISTER_TOKEN(IDENTIFIER); }
-\n                                          { if (USE_LEX_ONLY){printf("\n");}else{/* NOP */} }
+"true"|"false"                              { REGISTER_ATOM_TOKEN(BOOLEAN); }
+0|[1-9]{NUMBER_PTRN}*                       { REGISTER_ATOM_TOKEN(INTEGER); }
+{LETTER_PTRN}({ALPHANUM_PTRN}|$)*           { REGISTER_ATOM_TOKEN(IDENTIFIER); }
+\n                                          { if (USE_LEX_ONLY){PrintRaw("\n");}else{/* NOP */} }
 [ \t\r]+                                    { /* NOP */ }
-.                                           { if(!lexical_errors) fprintf(stderr, "Lexical errors found! See the logs below: \n"); fprintf(stderr, "\t@error at line %d. Character '%s' is not recognized.\n", yylineno, yytext); lexical_errors = 1;}
+.                                           { if(!yyextra->lexicalErrors) PrintRawErr("Lexical errors found! See the logs below: \n"); PrintRawErr("\t@error at line %d. Character '%s' is not recognized.\n", yylineno, yytext); yyextra->lexicalErrors = true;}
 <<EOF>>                                     { return yy::parser::make_END(); }
 
 %%
+
+Node* ParseSource(const char* source, size_t size, NodeArena& arena, bool& lexicalErrors)
+{
+    LexerState state = { source, size, 0, false };
+
+    yyscan_t scanner;
+    yylex_init_extra(&state, &scanner);
+
+    Node* rootNode = nullptr;
+    yy::parser parser(scanner, arena, rootNode);
+    bool parseSuccess = parser.parse() == 0;
+
+    yylex_destroy(scanner);
+
+    lexicalErrors = state.lexicalErrors;
+    return parseSuccess ? rootNode : nullptr;
+}
+
+bool LexSource(const char* source, size_t size)
+{
+    LexerState state = { source, size, 0, false };
+
+    yyscan_t scanner;
+    yylex_init_extra(&state, &scanner);
+
+    yylex(scanner);
+
+    yylex_destroy(scanner);
+
+    return state.lexicalErrors;
+}
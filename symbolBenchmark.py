@@ -0,0 +1,83 @@
+import os
+import subprocess
+import sys
+import time
+
+# Generates programs that stress the symbol tables and times how long the compiler takes on them.
+# Usage: python3 symbolBenchmark.py [compiler ...]
+# Every compiler given is timed on the same programs, which makes it easy to compare two builds.
+
+BENCHMARK_FOLDER = "benchmark_files"
+RUNS = 5
+
+def generate_class(lines, class_name, field_count, method_count, local_count, statement_count):
+    lines.append(f"class {class_name} {{")
+    for field in range(field_count):
+        lines.append(f"    int f{field};")
+
+    for method in range(method_count):
+        lines.append(f"    public int m{method}(int p) {{")
+        for local in range(local_count):
+            lines.append(f"        int l{local};")
+
+        # Every statement reads a field and a local, and assigns another local.
+        for statement in range(statement_count):
+            target = statement % local_count
+            local = (statement * 7 + method) % local_count
+            field = (statement * 31 + method * 17) % field_count
+            lines.append(f"        l{target} = l{local} + f{field};")
+
+        lines.append("        return p;")
+        lines.append("    }")
+    lines.append("}")
+
+def generate_program(file_path, class_count, field_count, method_count, local_count, statement_count):
+    lines = [
+        "public class Main {",
+        "    public static void main(String[] a) {",
+        "        System.out.println(new C0().m0(1));",
+        "    }",
+        "}",
+    ]
+    for class_id in range(class_count):
+        generate_class(lines, f"C{class_id}", field_count, method_count, local_count, statement_count)
+
+    with open(file_path, "w") as file:
+        file.write("\n".join(lines) + "\n")
+
+# Programs with many small tables, like most programs have, and with a few very large ones.
+PROGRAMS = {
+    "SmallTables.java": dict(class_count=400, field_count=8, method_count=10, local_count=6, statement_count=20),
+    "WideClass.java": dict(class_count=1, field_count=20000, method_count=200, local_count=6, statement_count=100),
+    "LongMethods.java": dict(class_count=4, field_count=50, method_count=10, local_count=2000, statement_count=2000),
+}
+
+def time_compiler(compiler, file_path):
+    # The fastest run is the one least disturbed by the rest of the system.
+    best = None
+    for _ in range(RUNS):
+        start = time.perf_counter()
+        process = subprocess.run([compiler, file_path], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        elapsed = time.perf_counter() - start
+        if process.returncode != 0:
+            return None
+        best = elapsed if best is None else min(best, elapsed)
+
+    return best
+
+def main():
+    compilers = sys.argv[1:] if len(sys.argv) > 1 else ["./compiler"]
+
+    os.makedirs(BENCHMARK_FOLDER, exist_ok=True)
+    for file_name, shape in PROGRAMS.items():
+        generate_program(os.path.join(BENCHMARK_FOLDER, file_name), **shape)
+
+    print(f"Best of {RUNS} runs in seconds:")
+    print(f"    {'program':<20}" + "".join(f"{compiler:>24}" for compiler in compilers))
+    for file_name in PROGRAMS:
+        file_path = os.path.join(BENCHMARK_FOLDER, file_name)
+        times = [time_compiler(compiler, file_path) for compiler in compilers]
+        print(f"    {file_name:<20}" + "".join(f"{'failed' if t is None else f'{t:.3f}':>24}" for t in times))
+
+if __name__ == "__main__":
+    main()
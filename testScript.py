@@ -17,9 +17,9 @@ class Colors:
 def colored(text, color):
     return f"{color}{text}{Colors.END}"
 
-def run_compiler(file_path):
+def run_compiler(file_path, options=[]):
     myinput = open(file_path, 'r')
-    process = subprocess.Popen(['./compiler', file_path], stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    process = subprocess.Popen(['./compiler'] + options + [file_path], stdout=subprocess.PIPE, stderr=subprocess.PIPE)
     stdout, stderr = process.communicate(timeout=10)
     return stdout.decode(), stderr.decode()
 
@@ -35,6 +35,49 @@ def extract_expected_errors(file_path):
 
     return expected_errors
 
+def extract_expected_output(file_path):
+    # Every '// @output - <value>' comment is the next line the program is expected to print
+    expected_output = []
+    output_pattern = re.compile(r'//\s*@output - (.*)')
+
+    with open(file_path, 'r') as file:
+        for line in file:
+            match = output_pattern.search(line)
+            if match:
+                expected_output.append(match.group(1).strip())
+
+    return expected_output
+
+def extract_expected_cfg(file_path):
+    # Every '// @cfg - <instruction>' comment is an instruction the optimized control flow graph must still hold
+    expected_cfg = []
+    cfg_pattern = re.compile(r'//\s*@cfg - (.*)')
+
+    with open(file_path, 'r') as file:
+        for line in file:
+            match = cfg_pattern.search(line)
+            if match:
+                expected_cfg.append(' '.join(match.group(1).split()))
+
+    return expected_cfg
+
+def parse_cfg_instructions(cfg_file_path):
+    # The instructions of each block are written to its label, separated by an escaped newline
+    instructions = set()
+    if not os.path.exists(cfg_file_path):
+        return instructions
+
+    with open(cfg_file_path, 'r') as file:
+        for instruction in file.read().split('\\n'):
+            instructions.add(' '.join(instruction.split()))
+
+    return instructions
+
+def parse_program_output(compiler_output):
+    # MiniJava programs can only print integers, everything else is printed by the compiler itself
+    output_pattern = re.compile(r'^-?\d+$')
+    return [line.strip() for line in compiler_output.splitlines() if output_pattern.match(line.strip())]
+
 def parse_compiler_errors(compiler_output):
     error_pattern = re.compile(r'@error at line (\d+). (.*)')
     errors = {}
@@ -44,6 +87,21 @@ def parse_compiler_errors(compiler_output):
         errors[line_number] = message
     return errors
 
+def test_passed(details):
+    expected_lines = set(details['expected_errors'].keys())
+    compiler_error_lines = set(details['compiler_errors'].keys())
+    if expected_lines != compiler_error_lines:
+        return False
+
+    if any(instruction not in details['cfg_instructions'] for instruction in details['expected_cfg']):
+        return False
+
+    # Programs with expected output are run on both virtual machines and from a bytecode file
+    if details['expected_output']:
+        return all(output == details['expected_output'] for output in details['program_output'].values())
+
+    return True
+
 def print_test_summary(id, file_name, success):
     status = colored("Success", Colors.DARK_GREEN) if success else colored("Fail", Colors.RED)
     print(f"    {id}: {file_name} - {status}")
@@ -63,10 +121,7 @@ def display_summary(file_details):
     for test_type, files in grouped_files.items():
         print(colored(f"\n{test_type.title()} Test Results:", Colors.GREEN))
         for file_id, details in files:
-            expected_lines = set(details['expected_errors'].keys())
-            compiler_error_lines = set(details['compiler_errors'].keys())
-            success = expected_lines == compiler_error_lines
-            print_test_summary(file_id, details['file_name'], success)
+            print_test_summary(file_id, details['file_name'], test_passed(details))
 
 def run_test_files(folder_path, test_type, file_details, global_id):
     print(colored(f"\nRunning {test_type} test classes...", Colors.GREEN))
@@ -76,12 +131,21 @@ def run_test_files(folder_path, test_type, file_details, global_id):
             expected_errors = extract_expected_errors(file_path)
             stdout, stderr = run_compiler(file_path)
             compiler_errors = parse_compiler_errors(stderr)
+            expected_output = extract_expected_output(file_path)
+            expected_cfg = extract_expected_cfg(file_path)
+            cfg_instructions = parse_cfg_instructions('CFG.dot') if expected_cfg else set()
+            program_output = {}
+
+            if expected_output:
+                program_output['bytecode'] = parse_program_output(stdout)
+                register_stdout, register_stderr = run_compiler(file_path, ['--register-vm'])
+                program_output['register'] = parse_program_output(register_stdout)
+
+                # Round trip through a bytecode file: write it, then map and run it on its own
+                run_compiler(file_path, ['--write-bytecode'])
+                mapped_stdout, mapped_stderr = run_compiler('bytecode.bin', ['--run-bytecode'])
+                program_output['mapped bytecode'] = parse_program_output(mapped_stdout)
 
-            # Check if all expected errors match the compiler-reported errors
-            expected_lines = set(expected_errors.keys())
-            compiler_error_lines = set(compiler_errors.keys())
-            success = expected_lines == compiler_error_lines
-            
             # Store file details including the test type
             file_details[global_id] = {
                 'file_name': file, 
@@ -89,9 +153,15 @@ def run_test_files(folder_path, test_type, file_details, global_id):
                 'stdout': stdout, 
                 'stderr': stderr, 
                 'expected_errors': expected_errors, 
-                'compiler_errors': compiler_errors
+                'compiler_errors': compiler_errors,
+                'expected_output': expected_output,
+                'program_output': program_output,
+                'expected_cfg': expected_cfg,
+                'cfg_instructions': cfg_instructions
             }
-            print_test_summary(global_id, file, success)
+
+            # Check if all expected errors match the compiler-reported errors and the program printed what was expected
+            print_test_summary(global_id, file, test_passed(file_details[global_id]))
             global_id += 1
 
     return global_id
@@ -125,13 +195,32 @@ def display_file_details(file_id, file_details, output_type=None):
                         print(colored(f"    Line {line_number}: {error_message}", Colors.ORANGE))
             else: 
                 print(colored("\n No Unexpected Compiler Errors Exist!", Colors.DARK_GREEN))
+
+        if output_type == "output" or (details['expected_output'] and not output_type):
+            if details['expected_output']:
+                print("\nExpected Output (Lines indicated with //@output in the test files):")
+                print("    " + " ".join(details['expected_output']))
+                for machine, output in details['program_output'].items():
+                    color = Colors.DARK_GREEN if output == details['expected_output'] else Colors.RED
+                    print(colored(f"    {machine.title()} VM: " + " ".join(output), color))
+            else:
+                print(colored("\n No Expected Output Exists!", Colors.DARK_GREEN))
+
+        if output_type == "cfg" or (details['expected_cfg'] and not output_type):
+            if details['expected_cfg']:
+                print("\nExpected CFG Instructions (Lines indicated with //@cfg in the test files):")
+                for instruction in details['expected_cfg']:
+                    color = Colors.DARK_GREEN if instruction in details['cfg_instructions'] else Colors.RED
+                    print(colored(f"    {instruction}", color))
+            else:
+                print(colored("\n No Expected CFG Instructions Exist!", Colors.DARK_GREEN))
     else:
         print(colored("Invalid file ID.", Colors.RED))
 
 
 def help_message():
     print("Commands:")
-    print("  <id> [output_type] - Display detailed results for the specified file ID. Optional output types: raw, expected, unexpected.")
+    print("  <id> [output_type] - Display detailed results for the specified file ID. Optional output types: raw, expected, unexpected, output, cfg.")
     print("  help - Display this help message.")
     print("  exit - Exit the script.")
 
@@ -0,0 +1,52 @@
+public class BlockLayout {
+    public static void main(String[] a) {
+        System.out.println(new Layout().Run(4));
+    }
+}
+
+class Layout {
+    public int Run(int n) {
+        int i;
+        int j;
+        int s;
+        i = 0;
+        s = 0;
+        while (i < n) {
+            j = 0;
+            while (j < i) {
+                System.out.println(i * 10 + j);
+                j = j + 1;
+            }
+            i = i + 1;
+        }
+        // @output - 10
+        // @output - 20
+        // @output - 21
+        // @output - 30
+        // @output - 31
+        // @output - 32
+        i = 0;
+        while (i < n) {
+            i = i + 1;
+            if (i < 3) {} else {
+                System.out.println(i);
+            }
+        }
+        // @output - 3
+        // @output - 4
+        i = 0;
+        while (i < n) {
+            j = 0;
+            while (j < n) {
+                j = j + 1;
+                if (j < i) {
+                    s = s + 1;
+                } else {
+                    j = j + 1;
+                }
+            }
+            i = i + 1;
+        }
+        return s; // @output - 3
+    }
+}
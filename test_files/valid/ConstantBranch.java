@@ -0,0 +1,30 @@
+public class ConstantBranch {
+    public static void main(String[] a) {
+        System.out.println(new Branch().Run(5));
+    }
+}
+
+class Branch {
+    public int Run(int n) {
+        int x;
+        int y;
+        x = 3;
+        y = 0;
+        if (x < 4)
+            y = 10; // @output - 10
+        else
+            y = 20;
+        System.out.println(y);
+        if (4 < x)
+            y = 30;
+        else
+            y = 40; // @output - 40
+        System.out.println(y);
+        if (true && !(x < 2))
+            y = y + n; // @output - 45
+        else
+            y = 0;
+        System.out.println(y);
+        return x; // @output - 3
+    }
+}
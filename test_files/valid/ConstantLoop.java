@@ -0,0 +1,34 @@
+public class ConstantLoop {
+    public static void main(String[] a) {
+        System.out.println(new Loop().Run(4));
+    }
+}
+
+class Loop {
+    public int Run(int n) {
+        int i;
+        int c;
+        int s;
+        i = 0;
+        c = 1;
+        s = 0;
+        while (i < n) {
+            s = s + c;
+            c = c * 2;
+            i = i + 1;
+        }
+        System.out.println(s); // @output - 15
+        System.out.println(c); // @output - 16
+        c = 7;
+        i = 0;
+        while (i < 3) {
+            System.out.println(c);
+            c = 5;
+            i = i + 1;
+        }
+        // @output - 7
+        // @output - 5
+        // @output - 5
+        return c; // @output - 5
+    }
+}
@@ -0,0 +1,65 @@
+public class ControlFlowSimplification {
+    public static void main(String[] a) {
+        System.out.println(new Blocks().Run(3));
+    }
+}
+
+class Blocks {
+    public int Run(int n) {
+        int i;
+        i = 0;
+        while (n < i) {}
+        while (this.Show(7) < 0) {}
+        // @output - 7
+        if (n < 0) {
+            while (true) {}
+        } else {}
+        if (this.Show(1) < 2) {} else {
+            if (this.Show(2) < 3) {} else {}
+        }
+        // @output - 1
+        if (n < this.Show(2)) {} else {
+            if (this.Show(3) < n) {} else {
+                if (n < 3) {} else {}
+            }
+        }
+        // @output - 2
+        // @output - 3
+        i = this.Count();
+        // @output - 0
+        // @output - 1
+        // @output - 2
+        i = i + this.Straight();
+        // @output - 4
+        return i; // @output - 9
+    }
+
+    public int Show(int value) {
+        System.out.println(value);
+        return value;
+    }
+
+    public int Count() {
+        int i;
+        i = 0;
+        while (i < 3) {
+            System.out.println(i);
+            i = i + 1;
+        }
+        return i;
+    }
+
+    public int Straight() {
+        int x;
+        if (true) {
+            x = 4;
+        } else {
+            x = 5;
+        }
+        {
+            System.out.println(x);
+        }
+        {}
+        return x + 2;
+    }
+}
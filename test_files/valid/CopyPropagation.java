@@ -0,0 +1,45 @@
+public class CopyPropagation {
+    public static void main(String[] a) {
+        System.out.println(new Copies().Run(3, 8));
+    }
+}
+
+class Copies {
+    int f;
+
+    public int Run(int a, int b) {
+        int t;
+        int x;
+        int r;
+        int i;
+        t = a;
+        a = b;
+        b = t;
+        System.out.println(a); // @output - 8
+        System.out.println(b); // @output - 3
+        x = a + b;
+        t = x;
+        x = 3;
+        r = t + x;
+        System.out.println(r); // @output - 14
+        i = 0;
+        r = 1;
+        t = 0;
+        while (i < 4) {
+            System.out.println(t);
+            t = r;
+            r = r + i;
+            i = i + 1;
+        }
+        // @output - 0
+        // @output - 1
+        // @output - 1
+        // @output - 2
+        System.out.println(t); // @output - 4
+        System.out.println(r); // @output - 7
+        f = a * b;
+        t = f;
+        f = 0;
+        return t + f; // @output - 24
+    }
+}
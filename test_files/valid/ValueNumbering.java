@@ -0,0 +1,56 @@
+public class ValueNumbering {
+    public static void main(String[] a) {
+        System.out.println(new Values().Run(3, 8));
+    }
+}
+
+class Values {
+    public int Run(int a, int b) {
+        int r;
+        r = this.Join(a, b);
+        // @output - 24
+        // @output - 32
+        r = this.Join(b, a);
+        // @output - 24
+        // @output - 24
+        r = this.Header(4);
+        // @output - 4
+        // @output - 8
+        // @output - 8
+        // @output - 12
+        // @output - 12
+        // @output - 16
+        // @output - 16
+        // @output - 20
+        return r; // @output - 20
+    }
+
+    public int Join(int a, int b) {
+        int x;
+        int z;
+        x = a * b;
+        System.out.println(x);
+        if (a < b)
+            a = a + 1;
+        else
+            x = x + 0;
+        z = a * b;
+        System.out.println(z);
+        return z;
+    }
+
+    public int Header(int k) {
+        int i;
+        int t;
+        i = 1;
+        t = 0;
+        while (i * k < 20) {
+            t = i * k;
+            System.out.println(t);
+            i = i + 1;
+            t = i * k;
+            System.out.println(t);
+        }
+        return i * k;
+    }
+}
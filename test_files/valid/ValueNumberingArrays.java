@@ -0,0 +1,29 @@
+public class ValueNumberingArrays {
+    public static void main(String[] a) {
+        System.out.println(new Arrays().Run(1));
+    }
+}
+
+class Arrays {
+    int[] numbers;
+
+    public int Run(int i) {
+        int x;
+        int y;
+        int z;
+        int w;
+        numbers = new int[4];
+        numbers[i] = 4;
+        x = numbers[i]; // @cfg - x := numbers [] i
+        numbers[i] = 9;
+        y = numbers[i]; // @cfg - y := numbers [] i
+        w = this.Clear();
+        z = numbers[i]; // @cfg - z := numbers [] i
+        return x + y + z + w;
+    }
+
+    public int Clear() {
+        numbers[1] = 0;
+        return 1;
+    }
+}
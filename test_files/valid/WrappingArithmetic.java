@@ -0,0 +1,19 @@
+public class WrappingArithmetic {
+    public static void main(String[] a) {
+        System.out.println(new Wrap().Run(1));
+    }
+}
+
+class Wrap {
+    public int Run(int one) {
+        int max;
+        int min;
+        max = 2147483647;
+        min = max + 1;
+        System.out.println(min); // @output - -2147483648
+        System.out.println(min - 1); // @output - 2147483647
+        System.out.println(max * 2); // @output - -2
+        System.out.println(0 - min); // @output - -2147483648
+        return max + one; // @output - -2147483648
+    }
+}